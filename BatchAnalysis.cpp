@@ -0,0 +1,260 @@
+// BatchAnalysis.cpp
+#include "BatchAnalysis.h"
+#include "FileParser.h"
+#include "MetaDecks.h"
+#include "MoveGen.h"
+#include "Utils.h"
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+#include <string_view>
+
+// --- Position Files ---
+
+// Parses "Name[, HP][, Type:n|Type:n][, Poisoned|Paralyzed]" into a board Pokémon.
+// Returns an empty slot if the card is unknown.
+static BoardPokemon parseBoardPokemon(std::string_view spec, const CardRegistry &registry) {
+    std::string_view name = nextToken(spec, ',');
+    CardId id = registry.find(name);
+    if (id == NO_CARD) {
+        if (!name.empty() && !equalsIgnoreCase(name, "none")) {
+            std::cerr << "Warning: Position card '" << name << "' not found in card database." << std::endl;
+        }
+        return BoardPokemon();
+    }
+
+    BoardPokemon p(id, registry.table()[id].hp);
+    while (!spec.empty()) {
+        std::string_view field = nextToken(spec, ',');
+        if (field.empty()) continue;
+        if (std::isdigit(static_cast<unsigned char>(field.front()))) {
+            p.hp = parseIntOrZero(field);
+        } else if (field.find(':') != std::string_view::npos) {
+            while (!field.empty()) {
+                std::string_view energy = nextToken(field, '|');
+                size_t pos = energy.find(':');
+                if (pos == std::string_view::npos) continue;
+                int type = energyIndex(std::string(trimView(energy.substr(0, pos))));
+                if (type >= 0) p.attachedEnergy.add(type, parseIntOrZero(energy.substr(pos + 1)));
+            }
+        } else {
+            while (!field.empty()) {
+                std::string_view status = nextToken(field, '|');
+                if (equalsIgnoreCase(status, "poisoned")) p.isPoisoned = true;
+                else if (equalsIgnoreCase(status, "paralyzed")) p.isParalyzed = true;
+                else if (!equalsIgnoreCase(status, "none")) {
+                    std::cerr << "Warning: Unrecognized status '" << status << "' for " << name << std::endl;
+                }
+            }
+        }
+    }
+    return p;
+}
+
+// Parses Pokémon separated by ';', skipping unknown cards.
+static void parseBoardList(std::string_view value, const CardRegistry &registry, std::vector<BoardPokemon> &out) {
+    while (!value.empty()) {
+        BoardPokemon p = parseBoardPokemon(nextToken(value, ';'), registry);
+        if (p.id != NO_CARD) out.push_back(std::move(p));
+    }
+}
+
+// Parses card names separated by ';', skipping unknown cards.
+static void parseCardList(std::string_view value, const CardRegistry &registry, std::vector<CardId> &out) {
+    while (!value.empty()) {
+        std::string_view name = nextToken(value, ';');
+        if (name.empty()) continue;
+        CardId id = registry.find(name);
+        if (id == NO_CARD) {
+            std::cerr << "Warning: Position card '" << name << "' not found in card database." << std::endl;
+            continue;
+        }
+        out.push_back(id);
+    }
+}
+
+// Applies one "Key: value" line of a position block.
+static void applyPositionField(std::string_view key, std::string_view value,
+                               const CardRegistry &registry, BatchPosition &position) {
+    GameState &state = position.state;
+    if (key == "Id") position.id = std::string(value);
+    else if (key == "Turn") state.turn = parseIntOrZero(value);
+    else if (key == "Points") state.yourPoints = parseIntOrZero(value);
+    else if (key == "OppPoints") state.opponentPoints = parseIntOrZero(value);
+    else if (key == "OppEnergy") state.opponentEnergyType = std::string(value);
+    else if (key == "Active") state.activePokemon = parseBoardPokemon(value, registry);
+    else if (key == "OppActive") state.opponentActivePokemon = parseBoardPokemon(value, registry);
+    else if (key == "Bench") parseBoardList(value, registry, state.bench);
+    else if (key == "OppBench") parseBoardList(value, registry, state.opponentBench);
+    else if (key == "Hand") parseCardList(value, registry, state.hand);
+    else if (key == "Deck") parseCardList(value, registry, state.deck);
+    else if (key == "OppAttached") {
+        while (!value.empty()) {
+            std::string_view type = nextToken(value, ';');
+            if (!type.empty()) state.oppAttachments.push_back({"", std::string(type), 1});
+        }
+    } else if (key == "OppAttacks") {
+        while (!value.empty()) {
+            std::string_view attacker = nextToken(value, ';');
+            if (attacker.empty()) continue;
+            if (registry.find(attacker) == NO_CARD) {
+                std::cerr << "Warning: Position card '" << attacker << "' not found in card database." << std::endl;
+                continue;
+            }
+            state.oppAttacks.push_back({std::string(attacker), "", "", {}});
+        }
+    } else {
+        std::cerr << "Warning: Unrecognized position field '" << key << "'" << std::endl;
+    }
+}
+
+// Loads recorded positions from a file.
+bool loadBatchPositions(const std::string &filename, const CardRegistry &registry,
+                        std::vector<BatchPosition> &positions) {
+    std::string buffer;
+    if (!readWholeFile(filename, buffer)) {
+        std::cerr << "Error: Cannot open position file: " << filename << std::endl;
+        return false;
+    }
+
+    std::string_view text(buffer);
+    std::string_view line;
+    BatchPosition *current = nullptr;
+    while (nextLine(text, line)) {
+        line = trimView(line);
+        if (line.empty() || line.front() == '#') continue;
+        if (line == "BEGIN_POSITION") {
+            positions.emplace_back();
+            current = &positions.back();
+            current->state.cards = &registry;
+            current->id = std::to_string(positions.size());
+        } else if (line == "END_POSITION") {
+            current = nullptr;
+        } else if (current != nullptr) {
+            size_t delimPos = line.find(':');
+            if (delimPos == std::string_view::npos) continue;
+            applyPositionField(trimView(line.substr(0, delimPos)), trimView(line.substr(delimPos + 1)),
+                               registry, *current);
+        }
+    }
+    return true;
+}
+
+// --- Analysis ---
+
+// Analyzes every position with the search and the Monte Carlo engine.
+std::vector<BatchResult> analyzePositions(std::vector<BatchPosition> &positions, const BatchOptions &options) {
+    std::vector<BatchResult> results(positions.size());
+
+    // Positions are the unit of parallelism: the parallel regions inside the
+    // engines run on the calling thread only.
+    int savedLevels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < static_cast<long>(positions.size()); ++i) {
+        GameState &state = positions[i].state;
+        BatchResult &result = results[i];
+        result.id = positions[i].id;
+
+        updateMetaDeckGuesses(state);
+        if (!state.oppMetaDeckGuesses.empty()) {
+            result.topMetaDeck = static_cast<int>(state.oppMetaDeckGuesses.front().deck);
+            result.topMetaProbability = state.oppMetaDeckGuesses.front().probability;
+        }
+        result.search = simulateDecisionTreeWithBudget(state, options.searchBudgetMs, options.maxDepth);
+        result.monteCarlo = monteCarloSimulation(state, options.rollouts, options.seed);
+        if (options.mcts) {
+            MctsOptions mctsOptions;
+            mctsOptions.mode = options.mctsMode;
+            mctsOptions.budgetMs = options.searchBudgetMs;
+            mctsOptions.seed = options.seed;
+            result.mcts = mctsSearch(state, mctsOptions);
+            result.mctsMove = describeMove(*state.cards, toSearchState(state).sides[0], result.mcts.bestMove);
+        }
+    }
+
+    omp_set_max_active_levels(savedLevels);
+    return results;
+}
+
+// --- Output ---
+
+// Writes a CSV field, quoted if it contains a delimiter or a quote.
+static void writeCsvField(std::ostream &out, std::string_view field) {
+    if (field.find_first_of(",\"\n") == std::string_view::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+// Writes a JSON string literal.
+static void writeJsonString(std::ostream &out, std::string_view s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c == '\n') out << "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+// Writes batch results as CSV or JSON Lines.
+void writeBatchResults(std::ostream &out, const std::vector<BatchResult> &results,
+                       const CardRegistry &registry, BatchFormat format, bool mcts) {
+    out << std::fixed << std::setprecision(6);
+    if (format == BATCH_CSV) {
+        out << "id,attacker,skill,search_value,search_depth,mc_win_rate,mc_ci_low,mc_ci_high,"
+               "top_meta_deck,top_meta_probability";
+        out << (mcts ? ",mcts_move,mcts_value,mcts_iterations\n" : "\n");
+    }
+    for (const BatchResult &r : results) {
+        bool hasMove = r.search.bestMove != NO_MOVE && r.search.attacker != NO_CARD;
+        std::string_view attacker = hasMove ? registry.name(r.search.attacker) : std::string_view();
+        std::string_view skill = hasMove ? registry.skillName(r.search.attacker, r.search.bestMove) : std::string_view();
+        // Meta-decks are numbered from 1, as in the interactive output.
+        int metaDeck = (r.topMetaDeck >= 0) ? r.topMetaDeck + 1 : 0;
+
+        if (format == BATCH_CSV) {
+            writeCsvField(out, r.id);
+            out << ',';
+            writeCsvField(out, attacker);
+            out << ',';
+            writeCsvField(out, skill);
+            out << ',' << r.search.value << ',' << r.search.depth << ',' << r.monteCarlo.winRate
+                << ',' << r.monteCarlo.ciLow << ',' << r.monteCarlo.ciHigh << ',' << metaDeck
+                << ',' << r.topMetaProbability;
+            if (mcts) {
+                out << ',';
+                writeCsvField(out, r.mctsMove);
+                out << ',' << r.mcts.value << ',' << r.mcts.iterations;
+            }
+            out << '\n';
+        } else {
+            out << "{\"id\":";
+            writeJsonString(out, r.id);
+            out << ",\"attacker\":";
+            writeJsonString(out, attacker);
+            out << ",\"skill\":";
+            writeJsonString(out, skill);
+            out << ",\"search_value\":" << r.search.value << ",\"search_depth\":" << r.search.depth
+                << ",\"mc_win_rate\":" << r.monteCarlo.winRate << ",\"mc_ci_low\":" << r.monteCarlo.ciLow
+                << ",\"mc_ci_high\":" << r.monteCarlo.ciHigh << ",\"top_meta_deck\":" << metaDeck
+                << ",\"top_meta_probability\":" << r.topMetaProbability;
+            if (mcts) {
+                out << ",\"mcts_move\":";
+                writeJsonString(out, r.mctsMove);
+                out << ",\"mcts_value\":" << r.mcts.value << ",\"mcts_iterations\":" << r.mcts.iterations;
+            }
+            out << "}\n";
+        }
+    }
+}
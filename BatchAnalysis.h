@@ -0,0 +1,81 @@
+// BatchAnalysis.h
+#ifndef BATCHANALYSIS_H
+#define BATCHANALYSIS_H
+
+#include "PokemonCard.h"
+#include "CardRegistry.h"
+#include "GameSimulation.h"
+#include "Mcts.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// A recorded position to analyze.
+struct BatchPosition {
+    std::string id;                 // Label copied to the output, e.g. "game42-turn3".
+    GameState state;
+};
+
+// Settings of a batch run, applied to every position.
+struct BatchOptions {
+    int searchBudgetMs = 1000;      // Time budget of the search per position.
+    int maxDepth = MAX_SEARCH_DEPTH; // Deepest search iteration per position.
+    int rollouts = 10000;           // Monte Carlo rollouts per position.
+    uint64_t seed = DEFAULT_MONTE_CARLO_SEED;
+    bool mcts = false;              // Also run the tree search with the same budget.
+    MctsMode mctsMode = MCTS_TREE_PARALLEL;
+};
+
+// Analysis of one position.
+struct BatchResult {
+    std::string id;
+    SearchResult search;
+    MonteCarloResult monteCarlo;
+    int topMetaDeck = -1;           // Most likely opponent meta-deck, -1 if unknown.
+    double topMetaProbability = 0.0;
+    MctsResult mcts;                // Filled if BatchOptions::mcts is set.
+    std::string mctsMove;           // Description of the tree search's move, empty if not run.
+};
+
+// Output formats of a batch run.
+enum BatchFormat { BATCH_CSV, BATCH_JSONL };
+
+// Loads recorded positions from a file of BEGIN_POSITION ... END_POSITION
+// blocks. Each block holds "Key: value" lines:
+//   Id, Turn, Points, OppPoints, OppEnergy     single values
+//   Active, OppActive                          one Pokémon
+//   Bench, OppBench                            Pokémon separated by ';'
+//   Hand, Deck                                 card names separated by ';'
+//   OppAttached                                energy types attached by the opponent, separated by ';'
+// A Pokémon is "Name[, HP][, Type:n|Type:n][, Poisoned|Paralyzed]"; the HP
+// defaults to the printed HP. Lines starting with '#' are comments.
+// Parameters:
+// - filename: The file to read.
+// - registry: The card registry to resolve card names against.
+// - positions: Output, the positions in file order.
+// Returns:
+// - false if the file cannot be read.
+bool loadBatchPositions(const std::string &filename, const CardRegistry &registry,
+                        std::vector<BatchPosition> &positions);
+
+// Analyzes every position with the search and the Monte Carlo engine.
+// Positions are distributed over the OpenMP threads, one position per thread
+// at a time; the engines run single-threaded inside each position.
+// Parameters:
+// - positions: The positions to analyze.
+// - options: Search and rollout settings.
+// Returns:
+// - One result per position, in input order.
+std::vector<BatchResult> analyzePositions(std::vector<BatchPosition> &positions, const BatchOptions &options);
+
+// Writes batch results as CSV (with a header line) or JSON Lines.
+// Parameters:
+// - out: The stream to write to.
+// - results: The results to write.
+// - registry: The card registry to name the best move.
+// - format: BATCH_CSV or BATCH_JSONL.
+// - mcts: Whether to add the tree search columns (BatchOptions::mcts).
+void writeBatchResults(std::ostream &out, const std::vector<BatchResult> &results,
+                       const CardRegistry &registry, BatchFormat format, bool mcts);
+
+#endif // BATCHANALYSIS_H
@@ -0,0 +1,412 @@
+// Bench.cpp
+// Benchmarks for the bench target.
+//
+// By default, runs the benchmark suite: card database, deck and meta-deck
+// loading, meta-deck filtering, state copies, node expansion, evaluation,
+// knockout kernels, draw odds, and full searches at depths 1 to 6 on 1 thread
+// up to the number of processors.
+// Results print as a table, or as Google Benchmark compatible JSON with --json
+// so runs of two releases can be compared.
+//
+// --scaling searches a fixed position at a fixed depth with 1 to 32 threads
+// and reports the speedup over one thread. The transposition table is
+// disabled unless --tt is given, so the benchmark measures how well the tree
+// itself is split across threads.
+//
+// --load writes a synthetic card database and meta-deck file to the temporary
+// directory and times the parallel loaders on them.
+//
+// Usage: bench [--filter <substring>] [--min-time <seconds>] [--json <file>]
+//        bench --scaling [depth] [--tt]
+//        bench --load [cards] [decks]
+// Run from the directory holding Cards.txt, deck.txt and metaDecks.txt.
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+#include "BenchHarness.h"
+#include "CardRegistry.h"
+#include "DrawOdds.h"
+#include "FileParser.h"
+#include "GameSimulation.h"
+#include "Knockouts.h"
+#include "Mcts.h"
+#include "MetaDecks.h"
+#include "MoveGen.h"
+#include "Rng.h"
+#include "TranspositionTable.h"
+
+static const char *const SYNTHETIC_TYPES[] = {"Grass", "Fire", "Water", "Lightning",
+                                              "Psychic", "Fighting", "Darkness", "Metal"};
+
+// Creates a board Pokémon at full HP, or an empty slot if the card is unknown.
+static BoardPokemon boardPokemon(const CardRegistry &registry, const std::string &name) {
+    CardId id = registry.find(name);
+    if (id == NO_CARD) {
+        std::cerr << "Warning: Benchmark card not found: " << name << std::endl;
+        return BoardPokemon();
+    }
+    return BoardPokemon(id, registry.table()[id].hp);
+}
+
+// Writes a card database of `count` synthetic Pokémon in the Cards.txt format.
+static void writeSyntheticCards(const std::string &filename, int count) {
+    std::ofstream out(filename);
+    CounterRng rng;
+    for (int i = 0; i < count; ++i) {
+        rng.reset(1, static_cast<uint64_t>(i));
+        const char *type = SYNTHETIC_TYPES[rng.below(8)];
+        out << "BEGIN_POKEMON\n"
+            << "Name: Synthetic " << i << "\n"
+            << "ex: " << (rng.below(4) == 0 ? "true" : "false") << "\n"
+            << "Type: " << type << "\n"
+            << "HP: " << 40 + 10 * rng.below(16) << "\n"
+            << "Stage: 0\nCanEvolve: false\n"
+            << "RetreatCost: " << rng.below(4) << "\n"
+            << "Weakness: " << SYNTHETIC_TYPES[rng.below(8)] << "\n"
+            << "PrevEvo: None\nNextEvo: None\n"
+            << "Skills: Tackle,20," << type << ":1,0,false,0;"
+            << "Double Hit,30," << type << ":1|Colorless:1,0,true,2\n"
+            << "SkillEffect: None;CoinFlip:30\n"
+            << "Abilities: None\n"
+            << "END_POKEMON\n";
+    }
+}
+
+// Writes `count` synthetic meta-decks of ten cards, two copies each, drawn
+// from the registry.
+static void writeSyntheticDecks(const std::string &filename, int count, const CardRegistry &registry) {
+    std::ofstream out(filename);
+    CounterRng rng;
+    uint32_t cards = static_cast<uint32_t>(registry.size());
+    for (int i = 0; i < count; ++i) {
+        rng.reset(2, static_cast<uint64_t>(i));
+        out << "BEGIN_DECK\nWeight: " << 1 + rng.below(100) << "\n";
+        for (int c = 0; c < 10; ++c) {
+            out << registry.name(static_cast<CardId>(rng.below(cards))) << ", 2\n";
+        }
+        out << "END_DECK\n\n";
+    }
+}
+
+// Returns the seconds taken by a call.
+template <typename F>
+static double timeIt(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Times the card and meta-deck loaders on synthetic files with 1 thread up to
+// the number of processors.
+static int runLoadBenchmark(const CardRegistry &registry, int numCards, int numDecks) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string cardFile = (dir / "tcgp_bench_cards.txt").string();
+    std::string deckFile = (dir / "tcgp_bench_decks.txt").string();
+    writeSyntheticCards(cardFile, numCards);
+    writeSyntheticDecks(deckFile, numDecks, registry);
+    double cardMb = std::filesystem::file_size(cardFile) / 1e6;
+    double deckMb = std::filesystem::file_size(deckFile) / 1e6;
+
+    std::cout << "Load scaling: " << numCards << " cards (" << std::fixed << std::setprecision(1) << cardMb
+              << " MB), " << numDecks << " meta-decks (" << deckMb << " MB)" << std::endl;
+    if (numCards >= NO_CARD) {
+        std::cout << "Note: the registry keeps the first " << NO_CARD
+                  << " cards; all blocks are still parsed." << std::endl;
+    }
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "cards (s)" << std::setw(10) << "MB/s"
+              << std::setw(14) << "decks (s)" << std::setw(10) << "MB/s" << std::endl;
+
+    for (int threads = 1; threads <= std::max(1, omp_get_num_procs()); threads *= 2) {
+        omp_set_num_threads(threads);
+        CardRegistry synthetic;
+        double cardSeconds = timeIt([&] { loadCardRegistryFromFile(cardFile, synthetic); });
+        double deckSeconds = timeIt([&] { loadAllMetaDecks(deckFile, registry); });
+        std::cout << std::setw(8) << threads << std::setw(14) << std::setprecision(4) << cardSeconds
+                  << std::setw(10) << std::setprecision(1) << cardMb / cardSeconds
+                  << std::setw(14) << std::setprecision(4) << deckSeconds
+                  << std::setw(10) << std::setprecision(1) << deckMb / deckSeconds << std::endl;
+    }
+
+    std::filesystem::remove(cardFile);
+    std::filesystem::remove(deckFile);
+    return 0;
+}
+
+// Searches a fixed position at a fixed depth with 1 to 32 threads and prints
+// the speedup over one thread.
+static int runScalingBenchmark(const GameState &state, int depth, bool useTable) {
+    transpositionTable.setEnabled(useTable);
+
+    std::cout << "Search scaling at depth " << depth
+              << (useTable ? " (transposition table on)" : " (transposition table off)") << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "seconds"
+              << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::endl;
+
+    double baseline = 0.0;
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        omp_set_num_threads(threads);
+        transpositionTable.clear();
+
+        double seconds = timeIt([&] { simulateDecisionTree(state, depth); });
+
+        if (threads == 1) baseline = seconds;
+        double speedup = baseline / seconds;
+        std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(4) << seconds
+                  << std::setw(10) << std::setprecision(2) << speedup
+                  << std::setw(11) << std::setprecision(0) << speedup / threads * 100 << "%" << std::endl;
+    }
+    if (omp_get_num_procs() < 32) {
+        std::cout << "Note: only " << omp_get_num_procs()
+                  << " processors available; larger thread counts are oversubscribed." << std::endl;
+    }
+    return 0;
+}
+
+// Returns the path of the card image written for CardDB/LoadImage.
+static std::string benchImagePath() {
+    return (std::filesystem::temp_directory_path() / "tcgp_bench_cards.bin").string();
+}
+
+// Registers the benchmark suite.
+// Parameters:
+// - suite: The suite to add the cases to.
+// - registry: The card registry loaded from Cards.txt.
+// - position: A mid-game position with both benches in play.
+// - searchPosition: A position whose lines all stay alive to the full depth.
+static void registerSuite(BenchSuite &suite, const CardRegistry &registry,
+                          const GameState &position, const GameState &searchPosition) {
+    // Loading.
+    suite.add("CardDB/LoadText", [](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            CardRegistry loaded;
+            loadCardRegistryFromFile("Cards.txt", loaded);
+            doNotOptimize(loaded.size());
+        }
+    });
+    std::string image = benchImagePath();
+    if (registry.saveImage(image)) {
+        suite.add("CardDB/LoadImage", [image](int64_t n) {
+            for (int64_t i = 0; i < n; ++i) {
+                CardRegistry loaded;
+                loaded.loadImage(image);
+                doNotOptimize(loaded.size());
+            }
+        });
+    }
+    suite.add("Deck/Load", [&registry](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            std::vector<CardId> deck;
+            loadPresetDeck("deck.txt", registry, deck);
+            doNotOptimize(deck.data());
+        }
+    });
+    suite.add("MetaDecks/Load", [&registry](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) loadAllMetaDecks("metaDecks.txt", registry);
+    });
+
+    // Opponent model.
+    std::vector<CardId> visible{position.opponentActivePokemon.id};
+    for (const auto &p : position.opponentBench) visible.push_back(p.id);
+    suite.add("MetaDecks/Filter", [visible](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) doNotOptimize(filterMetaDecksByVisibleBoard(visible).size());
+    });
+
+    // States.
+    suite.add("GameState/Copy", [&position](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            GameState copy = position;
+            doNotOptimize(copy.bench.data());
+        }
+    });
+    suite.add("GameState/ToSearchState", [&position](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) doNotOptimize(toSearchState(position));
+    });
+    const SearchState root = toSearchState(position);
+    suite.add("SearchState/Copy", [root](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) {
+            SearchState copy = root;
+            doNotOptimize(copy);
+        }
+    });
+
+    // Node expansion: every skill of the Active Pokémon.
+    suite.add("Search/ExpandNode", [root, &registry](int64_t n) {
+        const CardTable &table = registry.table();
+        const CardData &card = table[root.sides[0].active.card];
+        std::vector<ChanceOutcome> outcomes(MAX_CHANCE_OUTCOMES);
+        for (int64_t i = 0; i < n; ++i) {
+            for (int s = 0; s < card.skillCount; ++s) {
+                doNotOptimize(expandChanceOutcomes(root, table, card.skills[s], outcomes.data()));
+            }
+        }
+    });
+
+    // Legal move generation for the player.
+    suite.add("MoveGen/Generate", [root, &registry](int64_t n) {
+        MoveList moves;
+        for (int64_t i = 0; i < n; ++i) {
+            generateMoves(registry.table(), root.sides[0], root.sides[1], moves);
+            doNotOptimize(moves.count);
+        }
+    });
+
+    // Knockout kernels: the board matrix of the player against the opponent,
+    // and a scan of the whole card pool.
+    for (KernelIsa isa : {KERNEL_SCALAR, KERNEL_AVX2}) {
+        if (isa > detectKernelIsa()) continue;
+        std::string suffix = (isa == KERNEL_AVX2) ? "avx2" : "scalar";
+        suite.add("Knockouts/Board/" + suffix, [root, &registry, isa](int64_t n) {
+            KnockoutMatrix knockouts;
+            for (int64_t i = 0; i < n; ++i) {
+                findKnockouts(registry.table(), root.sides[0], root.sides[1], knockouts, isa);
+                doNotOptimize(knockouts.targets[0][0]);
+            }
+        });
+        suite.add("Knockouts/CardPool/" + suffix, [&registry, isa](int64_t n) {
+            std::vector<uint64_t> mask;
+            for (int64_t i = 0; i < n; ++i) {
+                knockoutCards(registry.table(), static_cast<int>(i % 200), static_cast<int>(i % ENERGY_TYPE_COUNT),
+                              mask, isa);
+                doNotOptimize(mask[0]);
+            }
+        });
+    }
+
+    // Exact draw odds of the longest evolution line in the deck, served from
+    // the memo after the first round of turns.
+    CardId line = NO_CARD;
+    for (CardId id : position.deck) {
+        if (line == NO_CARD || registry.table()[id].stage > registry.table()[line].stage) line = id;
+    }
+    if (line != NO_CARD) {
+        suite.add("DrawOdds/EvolutionLine", [&registry, &position, line](int64_t n) {
+            for (int64_t i = 0; i < n; ++i) {
+                int turn = 1 + static_cast<int>(i % DRAW_ODDS_TURNS);
+                doNotOptimize(evolutionLineByTurnProbability(registry.table(), position.deck, line, turn));
+            }
+        });
+    }
+
+    // Evaluation.
+    suite.add("Eval/GameState", [&position](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) doNotOptimize(evaluateGameState(position));
+    });
+    suite.add("Eval/SearchState", [root, &registry](int64_t n) {
+        for (int64_t i = 0; i < n; ++i) doNotOptimize(evaluateSearchState(root, registry.table()));
+    });
+
+    // Full searches without the transposition table, so every iteration
+    // searches the whole tree.
+    for (int depth = 1; depth <= 6; ++depth) {
+        for (int threads = 1; threads <= std::max(1, omp_get_num_procs()); threads *= 2) {
+            std::string name = "Search/depth:" + std::to_string(depth) + "/threads:" + std::to_string(threads);
+            suite.add(name, [&searchPosition, depth, threads](int64_t n) {
+                omp_set_num_threads(threads);
+                transpositionTable.setEnabled(false);
+                for (int64_t i = 0; i < n; ++i) doNotOptimize(simulateDecisionTree(searchPosition, depth));
+                transpositionTable.setEnabled(true);
+            });
+        }
+    }
+
+    // Tree searches of a fixed number of iterations in both parallel modes.
+    for (MctsMode mode : {MCTS_ROOT_PARALLEL, MCTS_TREE_PARALLEL}) {
+        for (int threads = 1; threads <= std::max(1, omp_get_num_procs()); threads *= 2) {
+            std::string name = std::string(mode == MCTS_ROOT_PARALLEL ? "Mcts/root" : "Mcts/tree") +
+                               "/iterations:1000/threads:" + std::to_string(threads);
+            suite.add(name, [&position, mode, threads](int64_t n) {
+                omp_set_num_threads(threads);
+                MctsOptions options;
+                options.mode = mode;
+                options.budgetMs = 0;
+                options.maxIterations = 1000;
+                options.maxNodes = 1 << 14;
+                for (int64_t i = 0; i < n; ++i) doNotOptimize(mctsSearch(position, options).iterations);
+            });
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    enum { SUITE, SCALING, LOAD } mode = SUITE;
+    int depth = 20;
+    bool useTable = false;
+    int numCards = 100000;
+    int numDecks = 1000000;
+    std::string filter;
+    std::string jsonFile;
+    double minSeconds = 0.5;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--scaling") == 0) {
+            mode = SCALING;
+            if (hasValue && argv[i + 1][0] != '-') depth = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tt") == 0) {
+            useTable = true;
+        } else if (std::strcmp(argv[i], "--load") == 0) {
+            mode = LOAD;
+            if (i + 1 < argc) numCards = std::atoi(argv[++i]);
+            if (i + 1 < argc) numDecks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue) {
+            minSeconds = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Error: Unrecognized argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    CardRegistry registry;
+    loadCardRegistryFromFile("Cards.txt", registry);
+    if (registry.empty()) return 1;
+    if (mode == LOAD) return runLoadBenchmark(registry, numCards, numDecks);
+
+    // A long fight between two high-HP Pokémon keeps every line alive to the
+    // full depth.
+    GameState searchPosition;
+    searchPosition.cards = &registry;
+    searchPosition.activePokemon = boardPokemon(registry, "Mewtwo ex");
+    searchPosition.opponentActivePokemon = boardPokemon(registry, "Venusaur ex");
+    searchPosition.opponentActivePokemon.hp = 30000;
+    if (mode == SCALING) return runScalingBenchmark(searchPosition, depth, useTable);
+
+    GameState position;
+    position.cards = &registry;
+    loadPresetDeck("deck.txt", registry, position.deck);
+    position.activePokemon = boardPokemon(registry, "Mewtwo ex");
+    position.activePokemon.attachedEnergy.add(ENERGY_PSYCHIC, 2);
+    position.bench.push_back(boardPokemon(registry, "Ralts"));
+    position.bench.push_back(boardPokemon(registry, "Kirlia"));
+    position.opponentActivePokemon = boardPokemon(registry, "Venusaur ex");
+    position.opponentActivePokemon.attachedEnergy.add(ENERGY_GRASS, 3);
+    position.opponentBench.push_back(boardPokemon(registry, "Bulbasaur"));
+    position.opponentEnergyType = "Grass";
+
+    loadAllMetaDecks("metaDecks.txt", registry);
+
+    int maxThreads = omp_get_max_threads();
+    BenchSuite suite;
+    registerSuite(suite, registry, position, searchPosition);
+    std::vector<BenchMeasurement> results = suite.run(filter, minSeconds);
+    omp_set_num_threads(maxThreads);
+    std::filesystem::remove(benchImagePath());
+
+    BenchSuite::writeTable(std::cout, results);
+    if (!jsonFile.empty()) {
+        std::ofstream out(jsonFile);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open " << jsonFile << std::endl;
+            return 1;
+        }
+        BenchSuite::writeJson(out, results, maxThreads);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+// BenchHarness.h
+// Minimal benchmark harness in the style of Google Benchmark, for the bench
+// target. Each case runs its body with a growing iteration count until the
+// run takes at least the minimum time, then reports the time per iteration.
+// Results print as a table or as Google Benchmark compatible JSON.
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Keeps the compiler from optimizing away a value computed by a benchmark.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char *sink = reinterpret_cast<const volatile char *>(&value);
+    (void)*sink;
+#endif
+}
+
+// Measured result of one benchmark case.
+struct BenchMeasurement {
+    std::string name;
+    int64_t iterations = 0;
+    double realNs = 0.0;            // Wall time per iteration.
+    double cpuNs = 0.0;             // Process CPU time per iteration, summed over threads.
+};
+
+// A set of named benchmark cases.
+class BenchSuite {
+public:
+    // The body runs the measured operation `iterations` times.
+    using Body = std::function<void(int64_t iterations)>;
+
+    // Registers a benchmark case.
+    void add(const std::string &name, Body body) { cases_.push_back({name, std::move(body)}); }
+
+    // Runs every case whose name contains `filter`.
+    // Parameters:
+    // - filter: Substring of the names to run; empty runs all.
+    // - minSeconds: Minimum measured time per case.
+    // Returns:
+    // - The measurements, in registration order.
+    std::vector<BenchMeasurement> run(const std::string &filter, double minSeconds) const {
+        std::vector<BenchMeasurement> results;
+        for (const Case &c : cases_) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+            c.body(1); // Warm-up.
+            int64_t iterations = 1;
+            for (;;) {
+                std::clock_t cpuStart = std::clock();
+                auto start = std::chrono::steady_clock::now();
+                c.body(iterations);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+                if (seconds >= minSeconds || iterations >= (int64_t(1) << 30)) {
+                    results.push_back({c.name, iterations, seconds * 1e9 / iterations, cpuSeconds * 1e9 / iterations});
+                    break;
+                }
+                // Aim just past the minimum time, growing at most 10x per round.
+                double scale = (seconds > 0.0) ? 1.4 * minSeconds / seconds : 10.0;
+                iterations = static_cast<int64_t>(iterations * (scale > 10.0 ? 10.0 : (scale < 2.0 ? 2.0 : scale)));
+            }
+        }
+        return results;
+    }
+
+    // Prints measurements as an aligned table.
+    static void writeTable(std::ostream &out, const std::vector<BenchMeasurement> &results) {
+        out << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(16) << "Time (ns)"
+            << std::setw(16) << "CPU (ns)" << std::setw(14) << "Iterations" << "\n";
+        for (const BenchMeasurement &m : results) {
+            out << std::left << std::setw(40) << m.name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(16) << m.realNs << std::setw(16) << m.cpuNs << std::setw(14) << m.iterations << "\n";
+        }
+    }
+
+    // Writes measurements in the JSON layout of Google Benchmark, so its
+    // comparison tools can diff two runs.
+    // Parameters:
+    // - out: The stream to write to.
+    // - results: The measurements.
+    // - threads: Maximum number of OpenMP threads, recorded in the context.
+    static void writeJson(std::ostream &out, const std::vector<BenchMeasurement> &results, int threads) {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"num_threads\": " << threads << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\"\n"
+#else
+            << "    \"library_build_type\": \"debug\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchMeasurement &m = results[i];
+            out << (i ? ",\n" : "\n") << std::fixed << std::setprecision(3)
+                << "    {\"name\": \"" << m.name << "\", \"run_type\": \"iteration\", \"iterations\": "
+                << m.iterations << ", \"real_time\": " << m.realNs << ", \"cpu_time\": " << m.cpuNs
+                << ", \"time_unit\": \"ns\"}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    struct Case {
+        std::string name;
+        Body body;
+    };
+    std::vector<Case> cases_;
+};
+
+#endif // BENCHHARNESS_H
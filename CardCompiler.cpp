@@ -0,0 +1,31 @@
+// CardCompiler.cpp
+// Compiles the text card database into a binary card image that the program
+// maps at startup instead of parsing the text file.
+//
+// Usage: compile_cards [Cards.txt] [Cards.bin]
+#include <iostream>
+#include "CardRegistry.h"
+#include "FileParser.h"
+
+int main(int argc, char **argv) {
+    const std::string textFile = (argc > 1) ? argv[1] : "Cards.txt";
+    const std::string imageFile = (argc > 2) ? argv[2] : "Cards.bin";
+
+    CardRegistry registry;
+    loadCardRegistryFromFile(textFile, registry);
+    if (registry.empty()) {
+        std::cerr << "Error: No cards loaded from " << textFile << std::endl;
+        return 1;
+    }
+    if (!registry.saveImage(imageFile)) return 1;
+
+    // Read the image back to make sure it loads.
+    CardRegistry check;
+    if (!check.loadImage(imageFile) || check.size() != registry.size()) {
+        std::cerr << "Error: " << imageFile << " failed verification." << std::endl;
+        return 1;
+    }
+    std::cout << "Compiled " << registry.size() << " cards into " << imageFile
+              << " (format version " << CARD_IMAGE_VERSION << ")." << std::endl;
+    return 0;
+}
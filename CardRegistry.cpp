@@ -0,0 +1,321 @@
+// CardRegistry.cpp
+#include "CardRegistry.h"
+#include "Utils.h"
+#include "EngineStats.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <cstdlib>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<CardData>::value, "CardData is stored in card images as raw bytes");
+static_assert(std::is_trivially_copyable<CardStrings>::value, "CardStrings is stored in card images as raw bytes");
+static_assert(std::is_trivially_copyable<CardNameEntry>::value, "CardNameEntry is stored in card images as raw bytes");
+
+// --- Binary Card Image ---
+//
+// Layout: header, card records, card strings, name index, string pool. Every
+// section starts on an 8-byte boundary; offsets follow from the counts in the
+// header.
+
+static const char CARD_IMAGE_MAGIC[8] = {'T', 'C', 'G', 'P', 'C', 'D', 'B', '\0'};
+
+struct CardImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(CardData) of the writer.
+    uint64_t cardCount;
+    uint64_t poolSize;
+    uint64_t checksum;          // Of every byte after the header.
+};
+
+// Byte offsets of the sections of an image.
+struct CardImageLayout {
+    size_t records, strings, index, pool, total;
+};
+
+static size_t alignTo8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+static CardImageLayout imageLayout(size_t cardCount, size_t poolSize) {
+    CardImageLayout layout;
+    layout.records = alignTo8(sizeof(CardImageHeader));
+    layout.strings = alignTo8(layout.records + cardCount * sizeof(CardData));
+    layout.index = alignTo8(layout.strings + cardCount * sizeof(CardStrings));
+    layout.pool = alignTo8(layout.index + cardCount * sizeof(CardNameEntry));
+    layout.total = layout.pool + poolSize;
+    return layout;
+}
+
+// 64-bit FNV-1a over 8-byte words, then over the remaining bytes.
+uint64_t imageChecksum(const char *data, size_t size) {
+    const uint64_t prime = 0x100000001B3ULL;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    return hash;
+}
+
+// Maps a whole file read-only. Returns nullptr on failure.
+void *mapFile(const std::string &filename, size_t &size) {
+#ifdef _WIN32
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) return nullptr;
+    size = static_cast<size_t>(file.tellg());
+    void *data = std::malloc(size > 0 ? size : 1);
+    file.seekg(0);
+    if (!data || !file.read(static_cast<char *>(data), static_cast<std::streamsize>(size))) {
+        std::free(data);
+        return nullptr;
+    }
+    return data;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    void *data = nullptr;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        size = static_cast<size_t>(info.st_size);
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = nullptr;
+    }
+    close(fd);
+    return data;
+#endif
+}
+
+// Releases a file mapped by mapFile().
+void unmapFile(void *data, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    std::free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// --- Registry ---
+
+CardRegistry::~CardRegistry() {
+    reset();
+}
+
+// Clears all data and unmaps a loaded image.
+void CardRegistry::reset() {
+    table_.clear();
+    ownedStrings_.clear();
+    ownedIndex_.clear();
+    ownedPool_.clear();
+    strings_ = nullptr;
+    index_ = nullptr;
+    pool_ = nullptr;
+    count_ = 0;
+    poolSize_ = 0;
+    if (image_) {
+        unmapFile(image_, imageSize_);
+        image_ = nullptr;
+        imageSize_ = 0;
+    }
+}
+
+// Adds a card to the registry.
+void CardRegistry::add(Pokemon card) {
+    pending_.push_back(std::move(card));
+}
+
+// Appends a string to the pool and returns its offset.
+static uint32_t poolAppend(std::string &pool, const std::string &s) {
+    uint32_t offset = static_cast<uint32_t>(pool.size());
+    pool += s;
+    return offset;
+}
+
+// Removes duplicates, assigns IDs, sorts the name index and builds the card table.
+void CardRegistry::finalize() {
+    std::vector<Pokemon> cards = std::move(pending_);
+    pending_.clear();
+    reset();
+
+    std::vector<std::pair<std::string, size_t>> order;
+    order.reserve(cards.size());
+    for (size_t i = 0; i < cards.size(); ++i) {
+        order.emplace_back(normalize(cards[i].name), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    // For duplicate names only the last definition survives.
+    std::vector<bool> keep(cards.size(), false);
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i + 1 == order.size() || order[i + 1].first != order[i].first) {
+            keep[order[i].second] = true;
+        }
+    }
+
+    std::vector<CardId> newId(cards.size(), NO_CARD);
+    std::vector<const Pokemon *> kept;
+    kept.reserve(cards.size());
+    size_t ignored = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (!keep[i]) continue;
+        if (kept.size() >= NO_CARD) {
+            ++ignored;
+            continue;
+        }
+        newId[i] = static_cast<CardId>(kept.size());
+        kept.push_back(&cards[i]);
+    }
+    if (ignored > 0) {
+        std::cerr << "Warning: Card registry is full; ignoring " << ignored << " cards." << std::endl;
+    }
+
+    for (const Pokemon *card : kept) {
+        CardStrings strings;
+        strings.name = poolAppend(ownedPool_, card->name);
+        strings.nameLength = static_cast<uint32_t>(card->name.size());
+        for (int s = 0; s < MAX_SKILLS && s < static_cast<int>(card->skills.size()); ++s) {
+            strings.skillName[s] = poolAppend(ownedPool_, card->skills[s].skillName);
+            strings.skillNameLength[s] = static_cast<uint32_t>(card->skills[s].skillName.size());
+        }
+        ownedStrings_.push_back(strings);
+        table_.add(*card);
+    }
+    for (const auto &entry : order) {
+        if (newId[entry.second] == NO_CARD) continue;
+        CardNameEntry indexEntry;
+        indexEntry.offset = poolAppend(ownedPool_, entry.first);
+        indexEntry.length = static_cast<uint32_t>(entry.first.size());
+        indexEntry.id = newId[entry.second];
+        ownedIndex_.push_back(indexEntry);
+    }
+
+    strings_ = ownedStrings_.data();
+    index_ = ownedIndex_.data();
+    pool_ = ownedPool_.data();
+    poolSize_ = ownedPool_.size();
+    count_ = kept.size();
+
+    for (size_t i = 0; i < kept.size(); ++i) {
+        table_.setPrevEvo(static_cast<CardId>(i), find(kept[i]->prevEvo));
+    }
+}
+
+// Writes the finalized registry as a binary card image.
+bool CardRegistry::saveImage(const std::string &filename) const {
+    CardImageLayout layout = imageLayout(count_, poolSize_);
+    std::vector<char> image(layout.total, 0);
+    if (count_ > 0) {
+        std::memcpy(image.data() + layout.records, table_.data(), count_ * sizeof(CardData));
+        std::memcpy(image.data() + layout.strings, strings_, count_ * sizeof(CardStrings));
+        std::memcpy(image.data() + layout.index, index_, count_ * sizeof(CardNameEntry));
+    }
+    if (poolSize_ > 0) std::memcpy(image.data() + layout.pool, pool_, poolSize_);
+
+    CardImageHeader header;
+    std::memcpy(header.magic, CARD_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = CARD_IMAGE_VERSION;
+    header.recordSize = sizeof(CardData);
+    header.cardCount = count_;
+    header.poolSize = poolSize_;
+    header.checksum = imageChecksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.write(image.data(), static_cast<std::streamsize>(image.size()))) {
+        std::cerr << "Error: Could not write card image " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Replaces the registry with a mapped binary card image.
+bool CardRegistry::loadImage(const std::string &filename) {
+    PhaseTimer timer(PHASE_LOAD);
+    pending_.clear();
+    reset();
+
+    size_t size = 0;
+    void *data = mapFile(filename, size);
+    if (!data) return false;
+    const char *bytes = static_cast<const char *>(data);
+
+    CardImageHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, bytes, sizeof(header));
+        valid = std::memcmp(header.magic, CARD_IMAGE_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == CARD_IMAGE_VERSION && header.recordSize == sizeof(CardData) &&
+                header.cardCount < NO_CARD &&
+                imageLayout(header.cardCount, header.poolSize).total == size &&
+                imageChecksum(bytes + sizeof(header), size - sizeof(header)) == header.checksum;
+    }
+    if (!valid) {
+        std::cerr << "Warning: " << filename << " is not a valid card image (version "
+                  << CARD_IMAGE_VERSION << ")." << std::endl;
+        unmapFile(data, size);
+        return false;
+    }
+
+    image_ = data;
+    imageSize_ = size;
+    CardImageLayout layout = imageLayout(header.cardCount, header.poolSize);
+    count_ = header.cardCount;
+    poolSize_ = header.poolSize;
+    table_.attach(reinterpret_cast<const CardData *>(bytes + layout.records), count_);
+    strings_ = reinterpret_cast<const CardStrings *>(bytes + layout.strings);
+    index_ = reinterpret_cast<const CardNameEntry *>(bytes + layout.index);
+    pool_ = bytes + layout.pool;
+    return true;
+}
+
+// Returns the ID of a card by name, or NO_CARD.
+CardId CardRegistry::find(std::string_view name) const {
+    if (name.empty() || count_ == 0) return NO_CARD;
+
+    // Normalize like normalize(), into a stack buffer for typical names.
+    char small[64];
+    std::string large;
+    char *buffer = small;
+    if (name.size() > sizeof(small)) {
+        large.resize(name.size());
+        buffer = large.data();
+    }
+    size_t length = 0;
+    for (char c : name) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            buffer[length++] = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    const std::string_view key(buffer, length);
+
+    const CardNameEntry *end = index_ + count_;
+    const CardNameEntry *it = std::lower_bound(index_, end, key,
+                                               [this](const CardNameEntry &entry, std::string_view k) {
+                                                   return std::string_view(pool_ + entry.offset, entry.length) < k;
+                                               });
+    return (it != end && std::string_view(pool_ + it->offset, it->length) == key) ? it->id : NO_CARD;
+}
+
+// Returns the display name of a card.
+std::string_view CardRegistry::name(CardId id) const {
+    return std::string_view(pool_ + strings_[id].name, strings_[id].nameLength);
+}
+
+// Returns the name of a card's skill, or an empty view if there is none.
+std::string_view CardRegistry::skillName(CardId id, int skill) const {
+    if (skill < 0 || skill >= table_[id].skillCount) return std::string_view();
+    return std::string_view(pool_ + strings_[id].skillName[skill], strings_[id].skillNameLength[skill]);
+}
@@ -0,0 +1,125 @@
+// CardRegistry.h
+#ifndef CARDREGISTRY_H
+#define CARDREGISTRY_H
+
+#include "PokemonCard.h"
+#include "SearchState.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Version of the binary card image format. Bump when CardData or the image
+// layout changes.
+const uint32_t CARD_IMAGE_VERSION = 3;
+
+// Strings of a card, as offsets and lengths into the registry's string pool.
+struct CardStrings {
+    uint32_t name = 0;
+    uint32_t nameLength = 0;
+    uint32_t skillName[MAX_SKILLS] = {};
+    uint32_t skillNameLength[MAX_SKILLS] = {};
+};
+
+// Entry of the name index: a normalized name in the string pool and its card.
+struct CardNameEntry {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    CardId id = NO_CARD;
+    uint16_t reserved = 0;
+};
+
+// Interned card database. Every card is stored once in a dense array indexed by
+// its CardId; decks, hands and boards refer to cards by ID. Names are resolved
+// through a sorted index of normalized names.
+//
+// The registry is either built from parsed cards (add() then finalize()) or
+// loaded from a binary card image written by saveImage(). Both produce the same
+// layout: fixed-size card records, fixed-size string references into one string
+// pool, and the name index. A loaded image is memory-mapped and used in place.
+class CardRegistry {
+public:
+    CardRegistry() = default;
+    CardRegistry(const CardRegistry &) = delete;
+    CardRegistry &operator=(const CardRegistry &) = delete;
+    ~CardRegistry();
+
+    // Adds a card. A later card with the same normalized name replaces the
+    // earlier one when the registry is finalized.
+    void add(Pokemon card);
+
+    // Removes duplicates, assigns IDs, sorts the name index and builds the
+    // compact card table. Call once after the last add().
+    void finalize();
+
+    // Writes the finalized registry as a binary card image.
+    // Parameters:
+    // - filename: Path of the image to write.
+    // Returns:
+    // - true on success.
+    bool saveImage(const std::string &filename) const;
+
+    // Replaces the registry with a binary card image, mapped into memory.
+    // The image is rejected if its magic, version, record size or checksum
+    // does not match.
+    // Parameters:
+    // - filename: Path of the image to load.
+    // Returns:
+    // - true on success; on failure the registry is left empty.
+    bool loadImage(const std::string &filename);
+
+    // Returns the ID of a card by name (case and whitespace insensitive), or NO_CARD.
+    CardId find(std::string_view name) const;
+
+    // Returns the display name of a card.
+    std::string_view name(CardId id) const;
+
+    // Returns the name of a card's skill, or an empty view if there is none.
+    std::string_view skillName(CardId id, int skill) const;
+
+    const CardTable &table() const { return table_; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    // Clears all data and unmaps a loaded image.
+    void reset();
+
+    std::vector<Pokemon> pending_;                 // Cards added since the last finalize().
+
+    // Storage of a registry built from parsed cards.
+    std::vector<CardStrings> ownedStrings_;
+    std::vector<CardNameEntry> ownedIndex_;
+    std::string ownedPool_;
+
+    // Views used by lookups: the owned storage or the mapped image.
+    const CardStrings *strings_ = nullptr;         // Indexed by CardId.
+    const CardNameEntry *index_ = nullptr;         // Sorted by normalized name.
+    const char *pool_ = nullptr;
+    size_t count_ = 0;
+    size_t poolSize_ = 0;
+    CardTable table_;                              // Hot data indexed by CardId.
+
+    void *image_ = nullptr;                        // Mapped image, if loaded.
+    size_t imageSize_ = 0;
+};
+
+// --- Binary File Helpers ---
+
+// Returns the 64-bit FNV-1a checksum of a byte range, taken over 8-byte words
+// and then the remaining bytes.
+uint64_t imageChecksum(const char *data, size_t size);
+
+// Maps a whole file read-only (or reads it into memory where mmap is not
+// available).
+// Parameters:
+// - filename: The file to map.
+// - size: Output, the size of the file.
+// Returns:
+// - The mapped bytes, or nullptr on failure or for an empty file.
+void *mapFile(const std::string &filename, size_t &size);
+
+// Releases a file mapped by mapFile().
+void unmapFile(void *data, size_t size);
+
+#endif // CARDREGISTRY_H
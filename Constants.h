@@ -7,5 +7,37 @@ const int MAX_BENCH = 3;           // Maximum of 3 Pokémon on the bench.
 const int MAX_HAND_SIZE = 10;      // Maximum hand size.
 const int INITIAL_HAND_SIZE = 5;   // Starting hand size.
 const int MAX_FLIP = 10;           // Maximum number of coin flips
+const int MAX_RANDOM_HITS = 4;     // Maximum number of random hits of one skill.
+const int MAX_SKILLS = 3;          // Maximum number of skills per Pokémon.
+const int MAX_EFFECT_OPS = 8;      // Maximum number of compiled effects per skill.
+const int DECK_SIZE = 20;          // Number of cards in a deck.
+const int MAX_COPIES = 2;          // Copies of one card allowed in a deck.
+const int POINTS_TO_WIN = 3;       // Points needed to win the game.
+const int WEAKNESS_BONUS = 20;     // Extra damage dealt to a Pokémon weak to the attacker.
+const int POISON_DAMAGE = 10;      // Damage dealt by poison between turns.
+const int MAX_MOVES = 64;          // Capacity of a move list; bounds the legal moves of a turn.
+const int MAX_DRAW_GROUPS = 4;     // Card groups one draw probability query can ask for.
+const int DRAW_ODDS_TURNS = 4;     // Turns covered by the draw odds shown before a game.
+
+// Simulation Constants
+const int MAX_ROLLOUT_TURNS = 40;    // Turn cap after which a rollout counts as a draw.
+const int MAX_SAMPLED_DECKS = 32;    // Most likely meta-decks sampled for the opponent in rollouts.
+const int TT_SIZE_LOG2 = 20;         // The transposition table has 2^TT_SIZE_LOG2 slots.
+const int MIN_TASK_DEPTH = 3;        // Search subtrees with less remaining depth run without tasks.
+const int MAX_HIT_SPREADS = 35;      // Ways to spread MAX_RANDOM_HITS hits: C(MAX_RANDOM_HITS + MAX_BENCH, MAX_BENCH).
+const int MAX_CHANCE_OUTCOMES = (MAX_FLIP + 1) * MAX_HIT_SPREADS * MAX_BENCH;  // Heads x spreads x switch targets.
+const int MAX_SEARCH_DEPTH = 64;     // Deepest iteration of an anytime search.
+const int SEARCH_ARENA_BLOCK_BYTES = 1 << 20;  // Growth step of the per-thread search node arenas.
+const int MCTS_MAX_NODES = 1 << 18;  // Node capacity of an MCTS tree.
+const int MCTS_MAX_PATH = 256;       // Deepest path followed through an MCTS tree.
+const int MCTS_VIRTUAL_LOSS = 1;     // Visits added to a path while a thread is inside it.
+const double MCTS_EXPLORATION = 1.4; // UCT exploration constant.
+
+// Loading Constants
+const int LOAD_CHUNK_BYTES = 1 << 18;  // Bytes of a card or meta-deck file parsed per parallel chunk.
+
+// Opponent Model Constants
+const double OFF_META_LIKELIHOOD = 0.01;    // Likelihood of an observation a deck list cannot explain.
+const double MIN_GUESS_PROBABILITY = 1e-6;  // Meta-deck guesses below this are not reported.
 
 #endif // CONSTANTS_H
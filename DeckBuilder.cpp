@@ -0,0 +1,306 @@
+// DeckBuilder.cpp
+#include "DeckBuilder.h"
+#include "MetaDecks.h"
+#include "MoveGen.h"
+#include "EngineStats.h"
+#include "Rng.h"
+#include <algorithm>
+#include <iostream>
+#include <omp.h>
+
+// Random stream that proposes deck changes; games use streams from 0 up.
+static const uint64_t PROPOSAL_STREAM = 1ULL << 62;
+
+// Meta-deck lists to play against, with their energy types and cumulative
+// prior weights.
+struct MetaOpponents {
+    std::vector<HiddenDeck> decks;
+    std::vector<int8_t> energyTypes;
+    std::vector<double> cumulative;
+};
+
+// Expands the meta-decks in `allMetaDecks` into playable lists.
+static MetaOpponents buildMetaOpponents(const CardTable &table) {
+    MetaOpponents meta;
+    double total = 0.0;
+    for (uint32_t d = 0; d < allMetaDecks.size(); ++d) {
+        double weight = allMetaDecks.weight(d);
+        if (weight <= 0.0) continue;
+        HiddenDeck deck;
+        auto range = allMetaDecks.deckCards(d);
+        for (const MetaDeckCard *entry = range.first; entry != range.second; ++entry) {
+            for (int c = 0; c < entry->count && deck.count < DECK_SIZE; ++c) deck.cards[deck.count++] = entry->card;
+        }
+        if (deck.count == 0) continue;
+        total += weight;
+        meta.decks.push_back(deck);
+        meta.energyTypes.push_back(static_cast<int8_t>(deckEnergyType(table, deck.cards, deck.count)));
+        meta.cumulative.push_back(total);
+    }
+    return meta;
+}
+
+// Result of one game of a deck, kept so that decks differing in one card can
+// take the game over.
+struct GameRecord {
+    float outcome = 0.0f;               // Win 1, draw 0.5, loss 0.
+    uint8_t lowWater = 0;               // Deck positions below this were never looked at.
+    uint8_t position[DECK_SIZE];        // Deck position of each deck slot after the shuffle.
+};
+
+// Draws an opening hand and puts a Basic Pokémon from it into the Active spot.
+// Opening hands always hold a Basic: if the drawn cards have none, the first
+// Basic from the top of the deck is swapped in.
+// Returns:
+// - The lowest deck position that was looked at.
+static int drawOpeningHand(const CardTable &table, SideState &side) {
+    int top = std::max(0, side.deckCount - INITIAL_HAND_SIZE);
+    int looked = top;
+    bool hasBasic = false;
+    for (int k = top; k < side.deckCount; ++k) hasBasic = hasBasic || isBasicPokemon(table[side.deck[k]]);
+    if (!hasBasic) {
+        looked = 0;
+        for (int k = top - 1; k >= 0; --k) {
+            if (isBasicPokemon(table[side.deck[k]])) {
+                std::swap(side.deck[k], side.deck[top]);
+                looked = k;
+                break;
+            }
+        }
+    }
+    while (side.handCount < INITIAL_HAND_SIZE && side.deckCount > 0) {
+        side.hand[side.handCount++] = side.deck[--side.deckCount];
+    }
+    for (int h = 0; h < side.handCount; ++h) {
+        if (!isBasicPokemon(table[side.hand[h]])) continue;
+        side.active.card = side.hand[h];
+        side.active.hp = table[side.hand[h]].hp;
+        side.hand[h] = side.hand[--side.handCount];
+        break;
+    }
+    return looked;
+}
+
+// Shuffles the first `count` entries of an array with the rollouts' shuffle.
+template <typename T>
+static void shuffle(T *items, int count, CounterRng &rng) {
+    for (int k = count - 1; k > 0; --k) std::swap(items[k], items[rng.below(static_cast<uint32_t>(k + 1))]);
+}
+
+// Plays game `game` of a deck against a meta-deck drawn by weight, with the
+// rollout policy for both players. The player goes first in even games.
+static GameRecord playDeckGame(const CardTable &table, const CardId *cards, int8_t energyType,
+                               const MetaOpponents &meta, uint64_t seed, uint64_t game) {
+    CounterRng rng(seed, game);
+    GameRecord record;
+    SearchState state;
+    SideState &me = state.sides[0];
+    SideState &opp = state.sides[1];
+
+    // Shuffle deck slots rather than cards, so every deck of this game puts
+    // slot s at the same position.
+    uint8_t order[DECK_SIZE];
+    for (int k = 0; k < DECK_SIZE; ++k) order[k] = static_cast<uint8_t>(k);
+    shuffle(order, DECK_SIZE, rng);
+    for (int k = 0; k < DECK_SIZE; ++k) {
+        me.deck[k] = cards[order[k]];
+        record.position[order[k]] = static_cast<uint8_t>(k);
+    }
+    me.deckCount = DECK_SIZE;
+    me.energyType = energyType;
+
+    double pick = rng.nextDouble() * meta.cumulative.back();
+    size_t d = std::upper_bound(meta.cumulative.begin(), meta.cumulative.end(), pick) - meta.cumulative.begin();
+    d = std::min(d, meta.decks.size() - 1);
+    std::copy(meta.decks[d].cards, meta.decks[d].cards + meta.decks[d].count, opp.deck);
+    opp.deckCount = static_cast<uint8_t>(meta.decks[d].count);
+    opp.energyType = meta.energyTypes[d];
+    shuffle(opp.deck, opp.deckCount, rng);
+
+    int lowWater = drawOpeningHand(table, me);
+    drawOpeningHand(table, opp);
+
+    double outcome = gameOutcome(state);
+    int first = static_cast<int>(game & 1);
+    int lastCount = me.deckCount;
+    for (int turn = 0; outcome < 0.0 && turn < MAX_ROLLOUT_TURNS; ++turn) {
+        SideState &side = state.sides[(turn + first) & 1];
+        SideState &other = state.sides[(turn + first + 1) & 1];
+        beginTurn(side);
+        playTurnGreedy(table, side, other, rng);
+        poisonCheckup(table, side, other);
+        poisonCheckup(table, other, side);
+        // A Pokémon shuffled back into the deck shifts the positions above it.
+        if (me.deckCount > lastCount) lowWater = 0;
+        lastCount = me.deckCount;
+        lowWater = std::min(lowWater, lastCount);
+        outcome = gameOutcome(state);
+    }
+    record.outcome = static_cast<float>(outcome < 0.0 ? 0.5 : outcome);
+    record.lowWater = static_cast<uint8_t>(lowWater);
+    countStat(COUNTER_ROLLOUTS);
+    return record;
+}
+
+// Plays the games of a deck. Runs the games in parallel unless called from a
+// parallel region.
+// Parameters:
+// - deck: The deck to evaluate.
+// - parent: Records of a deck that differs only in slot `changed`, or nullptr.
+// - changed: The slot that differs from the parent.
+// - records: Output, one record per game.
+// - played: Output, games simulated.
+// Returns:
+// - The win rate of the deck.
+static double evaluateDeck(const CardTable &table, const std::vector<CardId> &deck, const MetaOpponents &meta,
+                           const DeckBuilderOptions &options, const std::vector<GameRecord> *parent, int changed,
+                           std::vector<GameRecord> &records, long &played) {
+    const int games = options.gamesPerDeck;
+    records.resize(games);
+    const int8_t energyType = static_cast<int8_t>(deckEnergyType(table, deck.data(), deck.size()));
+    long simulated = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:simulated) if(!omp_in_parallel())
+    for (int i = 0; i < games; ++i) {
+        if (parent != nullptr && (*parent)[i].position[changed] < (*parent)[i].lowWater) {
+            records[i] = (*parent)[i];
+            continue;
+        }
+        records[i] = playDeckGame(table, deck.data(), energyType, meta, options.seed, static_cast<uint64_t>(i));
+        ++simulated;
+    }
+
+    double sum = 0.0;
+    for (const GameRecord &record : records) sum += record.outcome;
+    played = simulated;
+    return sum / games;
+}
+
+// Returns true if a deck can be played.
+bool isValidDeck(const CardTable &table, const std::vector<CardId> &deck) {
+    if (deck.size() != static_cast<size_t>(DECK_SIZE)) return false;
+    bool hasBasic = false;
+    for (CardId id : deck) {
+        if (id >= table.size() || std::count(deck.begin(), deck.end(), id) > MAX_COPIES) return false;
+        hasBasic = hasBasic || isBasicPokemon(table[id]);
+    }
+    return hasBasic;
+}
+
+// Proposes a deck that differs from `deck` in one slot.
+// Returns:
+// - The changed slot, or -1 if no valid change was found.
+static int proposeChange(const CardTable &table, const std::vector<CardId> &pool, const std::vector<CardId> &deck,
+                         CounterRng &rng, std::vector<CardId> &candidate) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        int slot = static_cast<int>(rng.below(DECK_SIZE));
+        CardId card = pool[rng.below(static_cast<uint32_t>(pool.size()))];
+        if (card == deck[slot]) continue;
+        candidate = deck;
+        candidate[slot] = card;
+        if (isValidDeck(table, candidate)) return slot;
+    }
+    return -1;
+}
+
+// Builds a random valid deck: two copies each of a Basic Pokémon and then of
+// random cards from the pool.
+static std::vector<CardId> randomDeck(const CardTable &table, std::vector<CardId> pool, CounterRng &rng) {
+    std::vector<CardId> deck;
+    shuffle(pool.data(), static_cast<int>(pool.size()), rng);
+    std::stable_partition(pool.begin(), pool.end(), [&table](CardId id) { return isBasicPokemon(table[id]); });
+    if (pool.empty() || !isBasicPokemon(table[pool.front()])) return deck;
+    deck.assign(MAX_COPIES, pool.front());
+    shuffle(pool.data() + 1, static_cast<int>(pool.size()) - 1, rng);
+    for (size_t i = 1; i < pool.size() && deck.size() < static_cast<size_t>(DECK_SIZE); ++i) {
+        for (int c = 0; c < MAX_COPIES && deck.size() < static_cast<size_t>(DECK_SIZE); ++c) deck.push_back(pool[i]);
+    }
+    if (!isValidDeck(table, deck)) deck.clear();
+    return deck;
+}
+
+// Searches the card pool for the deck with the best win rate against the meta-decks.
+DeckBuilderResult optimizeDeck(const CardRegistry &registry, const std::vector<CardId> &start,
+                               const DeckBuilderOptions &options) {
+    PhaseTimer timer(PHASE_ROLLOUT);
+    DeckBuilderResult result;
+    const CardTable &table = registry.table();
+    if (options.gamesPerDeck <= 0) return result;
+
+    const MetaOpponents meta = buildMetaOpponents(table);
+    if (meta.decks.empty()) {
+        std::cerr << "Error: No meta-decks to play against." << std::endl;
+        return result;
+    }
+
+    // Every Pokémon and Trainer card can go into a deck.
+    std::vector<CardId> pool;
+    for (size_t id = 0; id < table.size(); ++id) {
+        const CardData &card = table[static_cast<CardId>(id)];
+        if (card.cardType != 0 || card.hp > 0) pool.push_back(static_cast<CardId>(id));
+    }
+
+    CounterRng proposals(options.seed, PROPOSAL_STREAM);
+    std::vector<CardId> current = isValidDeck(table, start) ? start : randomDeck(table, pool, proposals);
+    if (current.empty()) {
+        std::cerr << "Error: The card pool cannot fill a deck of " << DECK_SIZE << " cards." << std::endl;
+        return result;
+    }
+
+    std::vector<GameRecord> records;
+    long played = 0;
+    double winRate = evaluateDeck(table, current, meta, options, nullptr, 0, records, played);
+    result.gamesPlayed += played;
+    result.decksEvaluated = 1;
+
+    const int batch = std::max(1, options.candidatesPerStep);
+    std::vector<std::vector<CardId>> candidates(batch);
+    std::vector<std::vector<GameRecord>> candidateRecords(batch);
+    std::vector<int> changed(batch);
+    std::vector<double> rates(batch);
+    std::vector<long> candidatePlayed(batch);
+    for (int step = 0; step < options.steps; ++step) {
+        for (int c = 0; c < batch; ++c) changed[c] = proposeChange(table, pool, current, proposals, candidates[c]);
+        const int8_t energyType = static_cast<int8_t>(deckEnergyType(table, current.data(), current.size()));
+
+        // One candidate per thread; the games of a candidate run in order.
+        #pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < batch; ++c) {
+            rates[c] = -1.0;
+            candidatePlayed[c] = 0;
+            if (changed[c] < 0) continue;
+            // Games are only comparable while the deck generates the same energy.
+            bool sameEnergy = deckEnergyType(table, candidates[c].data(), candidates[c].size()) == energyType;
+            rates[c] = evaluateDeck(table, candidates[c], meta, options, sameEnergy ? &records : nullptr, changed[c],
+                                    candidateRecords[c], candidatePlayed[c]);
+        }
+
+        int best = -1;
+        for (int c = 0; c < batch; ++c) {
+            if (changed[c] < 0) continue;
+            ++result.decksEvaluated;
+            result.gamesPlayed += candidatePlayed[c];
+            result.gamesReused += options.gamesPerDeck - candidatePlayed[c];
+            if (best < 0 || rates[c] > rates[best]) best = c;
+        }
+        if (best >= 0 && rates[best] > winRate) {
+            current = candidates[best];
+            records.swap(candidateRecords[best]);
+            winRate = rates[best];
+        }
+    }
+
+    result.deck = current;
+    result.winRate = winRate;
+    return result;
+}
+
+// Writes a deck as "Name, count" lines.
+void writeDeckFile(std::ostream &out, const CardRegistry &registry, const std::vector<CardId> &deck) {
+    std::vector<CardId> seen;
+    for (CardId id : deck) {
+        if (std::find(seen.begin(), seen.end(), id) != seen.end()) continue;
+        seen.push_back(id);
+        out << registry.name(id) << ", " << std::count(deck.begin(), deck.end(), id) << "\n";
+    }
+}
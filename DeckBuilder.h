@@ -0,0 +1,55 @@
+// DeckBuilder.h
+#ifndef DECKBUILDER_H
+#define DECKBUILDER_H
+
+#include "PokemonCard.h"
+#include "CardRegistry.h"
+#include "MonteCarlo.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Settings of the deck optimizer.
+struct DeckBuilderOptions {
+    int gamesPerDeck = 2000;        // Simulated games per candidate deck.
+    int steps = 50;                 // Hill climbing rounds.
+    int candidatesPerStep = 16;     // One-card changes evaluated per round, in parallel.
+    uint64_t seed = DEFAULT_MONTE_CARLO_SEED;
+};
+
+// Best deck found by the optimizer.
+struct DeckBuilderResult {
+    std::vector<CardId> deck;       // DECK_SIZE cards; empty if no deck could be built.
+    double winRate = 0.0;           // Win rate against the weighted meta-decks.
+    int decksEvaluated = 0;
+    long gamesPlayed = 0;           // Games simulated.
+    long gamesReused = 0;           // Games taken over from the parent deck unchanged.
+};
+
+// Returns true if a deck has DECK_SIZE cards, at most MAX_COPIES of each card
+// and at least one Basic Pokémon.
+bool isValidDeck(const CardTable &table, const std::vector<CardId> &deck);
+
+// Searches the card pool for the deck with the best win rate against the
+// meta-decks in `allMetaDecks`, weighted by their prior weights. Starting
+// from `start` (or a random valid deck if it is not valid), each round
+// evaluates a batch of decks that differ from the current one by one card in
+// parallel and keeps the best if it improves the win rate.
+//
+// Every deck plays the same games: game i uses random stream i for shuffles,
+// opponents and coin flips, so decks are compared on common random numbers.
+// A game in which the changed card was never drawn plays out identically, so
+// its result is reused from the parent deck instead of simulated again.
+// Parameters:
+// - registry: The card pool.
+// - start: The deck to start from, e.g. deck.txt.
+// - options: Search settings.
+// Returns:
+// - The best deck found and its win rate.
+DeckBuilderResult optimizeDeck(const CardRegistry &registry, const std::vector<CardId> &start,
+                               const DeckBuilderOptions &options = DeckBuilderOptions());
+
+// Writes a deck as "Name, count" lines, the format of deck.txt.
+void writeDeckFile(std::ostream &out, const CardRegistry &registry, const std::vector<CardId> &deck);
+
+#endif // DECKBUILDER_H
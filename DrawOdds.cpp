@@ -0,0 +1,208 @@
+// DrawOdds.cpp
+#include "DrawOdds.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+static_assert(18 + 11 * MAX_DRAW_GROUPS <= 64, "A draw query must pack into a 64-bit memo key.");
+
+// Binomial coefficients C(n, k) for n and k up to DECK_SIZE, built by
+// Pascal's rule at compile time.
+struct BinomialTable {
+    double values[DECK_SIZE + 1][DECK_SIZE + 1] = {};
+
+    constexpr BinomialTable() {
+        for (int n = 0; n <= DECK_SIZE; ++n) {
+            values[n][0] = 1.0;
+            for (int k = 1; k <= n; ++k) values[n][k] = values[n - 1][k - 1] + (k < n ? values[n - 1][k] : 0.0);
+        }
+    }
+};
+
+static constexpr BinomialTable BINOMIAL;
+
+// Returns C(n, k), or 0 if k is out of range.
+static inline double choose(int n, int k) {
+    return (k < 0 || k > n) ? 0.0 : BINOMIAL.values[n][k];
+}
+
+// Enumeration of the ways to deal a query's groups into the opening hand and
+// the later draws. Hands are weighted by their number of card combinations.
+struct DrawEnumeration {
+    const DrawQuery *query;
+    int hand;                           // Cards in the opening hand.
+    int later;                          // Cards drawn after the opening hand.
+    int otherBasics;                    // Basic Pokémon outside the groups.
+    int others;                         // Other cards outside the groups.
+    int held[MAX_DRAW_GROUPS];          // Copies of each group in the opening hand.
+    double hit = 0.0;                   // Hands with a Basic that go on to meet the query.
+    double dealt = 0.0;                 // Hands with a Basic.
+    double hitAnyHand = 0.0;            // Hands that go on to meet the query.
+};
+
+// Returns the number of ways to draw `left` more cards that bring every group
+// from `g` on up to its need, with `pool` cards outside the groups left.
+static double laterWays(const DrawEnumeration &e, int g, int left, int pool) {
+    if (g >= e.query->groupCount || g >= MAX_DRAW_GROUPS) return choose(pool, left);
+    const DrawGroup &group = e.query->groups[g];
+    int remaining = group.count - e.held[g];
+    double ways = 0.0;
+    for (int y = std::max(0, group.need - e.held[g]); y <= std::min(remaining, left); ++y) {
+        ways += choose(remaining, y) * laterWays(e, g + 1, left - y, pool);
+    }
+    return ways;
+}
+
+// Deals the opening hand's copies of group `g` and on, then the cards outside
+// the groups, and adds every finished hand to the totals.
+static void dealHand(DrawEnumeration &e, int g, int left, double ways, bool hasBasic) {
+    if (g < e.query->groupCount && g < MAX_DRAW_GROUPS) {
+        const DrawGroup &group = e.query->groups[g];
+        for (int x = 0; x <= std::min<int>(group.count, left); ++x) {
+            e.held[g] = x;
+            dealHand(e, g + 1, left - x, ways * choose(group.count, x), hasBasic || (group.basic && x > 0));
+        }
+        return;
+    }
+    const double laterTotal = choose(e.query->deckSize - e.hand, e.later);
+    for (int basics = 0; basics <= std::min(e.otherBasics, left); ++basics) {
+        double handWays = ways * choose(e.otherBasics, basics) * choose(e.others, left - basics);
+        if (handWays == 0.0) continue;
+        int pool = (e.otherBasics - basics) + (e.others - (left - basics));
+        double hit = handWays * laterWays(e, 0, e.later, pool) / laterTotal;
+        e.hitAnyHand += hit;
+        if (hasBasic || basics > 0) {
+            e.hit += hit;
+            e.dealt += handWays;
+        }
+    }
+}
+
+// Computes a normalized query without the memo.
+static double computeDrawProbability(const DrawQuery &query) {
+    DrawEnumeration e;
+    e.query = &query;
+    e.hand = std::min<int>(INITIAL_HAND_SIZE, query.deckSize);
+    e.later = query.drawn - e.hand;
+    int groupCards = 0;
+    int groupBasics = 0;
+    for (int g = 0; g < query.groupCount; ++g) {
+        groupCards += query.groups[g].count;
+        if (query.groups[g].basic) groupBasics += query.groups[g].count;
+    }
+    e.otherBasics = query.basics - groupBasics;
+    e.others = query.deckSize - groupCards - e.otherBasics;
+    if (e.otherBasics < 0 || e.others < 0) return 0.0;
+
+    dealHand(e, 0, e.hand, 1.0, false);
+    // A deck without Basic Pokémon cannot be redealt into one.
+    if (e.dealt == 0.0) return e.hitAnyHand / choose(query.deckSize, e.hand);
+    return e.hit / e.dealt;
+}
+
+// Computes the exact probability of a draw query, memoized per thread.
+double drawProbability(const DrawQuery &query) {
+    if (query.deckSize > DECK_SIZE || query.groupCount > MAX_DRAW_GROUPS) return -1.0;
+
+    // Normalize so that equal questions share a memo entry.
+    DrawQuery q = query;
+    q.drawn = std::min(q.drawn, q.deckSize);
+    q.drawn = std::max<uint8_t>(q.drawn, static_cast<uint8_t>(std::min<int>(INITIAL_HAND_SIZE, q.deckSize)));
+    uint64_t key = q.deckSize | q.basics << 5 | q.drawn << 10 | static_cast<uint64_t>(q.groupCount) << 15;
+    for (int g = 0; g < q.groupCount; ++g) {
+        DrawGroup &group = q.groups[g];
+        group.need = std::min<uint8_t>(group.need, group.count + 1);
+        uint64_t packed = group.count | group.need << 5 | static_cast<uint64_t>(group.basic) << 10;
+        key |= packed << (18 + 11 * g);
+    }
+
+    thread_local std::unordered_map<uint64_t, double> memo;
+    auto it = memo.find(key);
+    if (it != memo.end()) return it->second;
+    double probability = computeDrawProbability(q);
+    memo.emplace(key, probability);
+    return probability;
+}
+
+// Returns a query about a deck's draws by the start of turn `turn`, without groups.
+static DrawQuery deckQuery(const CardTable &table, const std::vector<CardId> &deck, int turn) {
+    DrawQuery query;
+    query.deckSize = static_cast<uint8_t>(std::min<size_t>(deck.size(), DECK_SIZE + 1));
+    query.basics = static_cast<uint8_t>(std::min<long>(
+        std::count_if(deck.begin(), deck.end(), [&table](CardId id) { return isBasicPokemon(table[id]); }),
+        DECK_SIZE + 1));
+    query.drawn = static_cast<uint8_t>(std::min<int>(INITIAL_HAND_SIZE + std::max(0, turn), query.deckSize));
+    return query;
+}
+
+// Returns the group of a card's copies in a deck.
+static DrawGroup cardGroup(const CardTable &table, const std::vector<CardId> &deck, CardId card, int need) {
+    DrawGroup group;
+    group.count = static_cast<uint8_t>(std::min<long>(std::count(deck.begin(), deck.end(), card), DECK_SIZE));
+    group.need = static_cast<uint8_t>(std::clamp(need, 0, DECK_SIZE + 1));
+    group.basic = isBasicPokemon(table[card]);
+    return group;
+}
+
+// Returns the probability that the opening hand is dealt with a Basic.
+double openingBasicProbability(const CardTable &table, const std::vector<CardId> &deck) {
+    DrawQuery query = deckQuery(table, deck, 0);
+    if (query.deckSize > DECK_SIZE) return -1.0;
+    int hand = std::min<int>(INITIAL_HAND_SIZE, query.deckSize);
+    return 1.0 - choose(query.deckSize - query.basics, hand) / choose(query.deckSize, hand);
+}
+
+// Returns the probability of having drawn `basics` Basic Pokémon by a turn.
+double basicsByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, int basics, int turn) {
+    DrawQuery query = deckQuery(table, deck, turn);
+    query.groupCount = 1;
+    query.groups[0].count = query.basics;
+    query.groups[0].need = static_cast<uint8_t>(std::clamp(basics, 0, DECK_SIZE + 1));
+    query.groups[0].basic = true;
+    return drawProbability(query);
+}
+
+// Returns the probability of having drawn copies of a card by a turn.
+double cardByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, CardId card,
+                             int turn, int copies) {
+    DrawQuery query = deckQuery(table, deck, turn);
+    query.groupCount = 1;
+    query.groups[0] = cardGroup(table, deck, card, copies);
+    return drawProbability(query);
+}
+
+// Returns the probability of having drawn a whole evolution line by a turn.
+double evolutionLineByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, CardId card,
+                                      int turn) {
+    DrawQuery query = deckQuery(table, deck, turn);
+    for (CardId id = card; id != NO_CARD && query.groupCount < MAX_DRAW_GROUPS; id = table[id].prevEvo) {
+        query.groups[query.groupCount++] = cardGroup(table, deck, id, 1);
+    }
+    return drawProbability(query);
+}
+
+// Prints the draw odds of a deck.
+void printDrawOdds(std::ostream &out, const CardRegistry &registry, const std::vector<CardId> &deck, int turns) {
+    const CardTable &table = registry.table();
+    double opening = openingBasicProbability(table, deck);
+    if (opening < 0.0) return;
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    text << "Opening hand dealt with a Basic without a redeal: " << opening * 100.0 << "%" << std::endl;
+
+    std::vector<CardId> lines;
+    for (CardId id : deck) {
+        if (table[id].prevEvo == NO_CARD || std::find(lines.begin(), lines.end(), id) != lines.end()) continue;
+        lines.push_back(id);
+    }
+    if (!lines.empty()) text << "Chance of holding each evolution line by turn 1 to " << turns << ":" << std::endl;
+    for (CardId id : lines) {
+        text << "  " << registry.name(id) << ":";
+        for (int turn = 1; turn <= turns; ++turn) {
+            text << " " << evolutionLineByTurnProbability(table, deck, id, turn) * 100.0 << "%";
+        }
+        text << std::endl;
+    }
+    out << text.str();
+}
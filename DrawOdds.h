@@ -0,0 +1,65 @@
+// DrawOdds.h
+#ifndef DRAWODDS_H
+#define DRAWODDS_H
+
+#include "SearchState.h"
+#include "CardRegistry.h"
+#include "Constants.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Cards of the deck that a draw query asks for, e.g. one card or one stage of
+// an evolution line.
+struct DrawGroup {
+    uint8_t count = 0;      // Copies in the deck.
+    uint8_t need = 1;       // Copies that must be drawn.
+    bool basic = false;     // Whether the cards are Basic Pokémon.
+};
+
+// Question about the cards drawn from a shuffled deck: do the first `drawn`
+// cards hold at least `need` cards of every group? The first
+// INITIAL_HAND_SIZE cards are the opening hand, which always holds a Basic
+// Pokémon: hands without one are redealt, so every answer is conditioned on it.
+struct DrawQuery {
+    uint8_t deckSize = DECK_SIZE;   // Cards in the deck.
+    uint8_t basics = 0;             // Basic Pokémon in the deck, in the groups or not.
+    uint8_t drawn = INITIAL_HAND_SIZE;  // Opening hand plus cards drawn since.
+    uint8_t groupCount = 0;
+    DrawGroup groups[MAX_DRAW_GROUPS];
+};
+
+// Computes the exact probability of a draw query with the multivariate
+// hypergeometric distribution over the deck's card counts. Answers are
+// memoized per thread, so repeated queries are a hash lookup.
+// Parameters:
+// - query: The query; its groups must not share cards.
+// Returns:
+// - The probability, or -1 if the deck holds more than DECK_SIZE cards.
+double drawProbability(const DrawQuery &query);
+
+// Returns the probability that the first INITIAL_HAND_SIZE cards dealt from
+// a deck hold a Basic Pokémon, i.e. that the opening hand is not redealt.
+double openingBasicProbability(const CardTable &table, const std::vector<CardId> &deck);
+
+// Returns the probability of having drawn at least `basics` Basic Pokémon by
+// the start of the player's turn `turn`. Turn 0 is the opening hand; every
+// turn draws one card.
+double basicsByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, int basics, int turn);
+
+// Returns the probability of having drawn at least `copies` copies of a card
+// by the start of the player's turn `turn`.
+double cardByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, CardId card,
+                             int turn, int copies = 1);
+
+// Returns the probability of having drawn every stage of a card's evolution
+// line, from its Basic Pokémon (via prevEvo) up to the card itself, by the
+// start of the player's turn `turn`.
+double evolutionLineByTurnProbability(const CardTable &table, const std::vector<CardId> &deck, CardId card,
+                                      int turn);
+
+// Prints the opening hand odds and the odds of completing each evolution
+// line of the deck by turns 1 to `turns`.
+void printDrawOdds(std::ostream &out, const CardRegistry &registry, const std::vector<CardId> &deck, int turns);
+
+#endif // DRAWODDS_H
@@ -0,0 +1,15 @@
+// Energy.cpp
+#include "Energy.h"
+
+// Maps an energy or Pokémon type name to its EnergyIndex.
+int energyIndex(const std::string &type) {
+    if (type == "Grass") return ENERGY_GRASS;
+    if (type == "Fire") return ENERGY_FIRE;
+    if (type == "Water") return ENERGY_WATER;
+    if (type == "Lightning" || type == "Electric") return ENERGY_LIGHTNING;
+    if (type == "Psychic") return ENERGY_PSYCHIC;
+    if (type == "Fighting") return ENERGY_FIGHTING;
+    if (type == "Darkness") return ENERGY_DARKNESS;
+    if (type == "Metal") return ENERGY_METAL;
+    return ENERGY_COLORLESS;
+}
@@ -0,0 +1,61 @@
+// Energy.h
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <cstdint>
+#include <string>
+
+// Energy types that can be attached. Colorless and "Any" requirements are
+// paid with any of these.
+enum EnergyIndex : int8_t {
+    ENERGY_COLORLESS = -1,  // Colorless requirements; also "no type".
+    ENERGY_GRASS, ENERGY_FIRE, ENERGY_WATER, ENERGY_LIGHTNING,
+    ENERGY_PSYCHIC, ENERGY_FIGHTING, ENERGY_DARKNESS, ENERGY_METAL,
+    ENERGY_TYPE_COUNT
+};
+
+// Maps an energy or Pokémon type name to its EnergyIndex.
+// Returns -1 for Colorless, Any and types that have no energy.
+int energyIndex(const std::string &type);
+
+// Energy counts of every type packed into one 64-bit word, one byte per type
+// in EnergyIndex order. Counts stay below 128, so byte-wise arithmetic never
+// borrows from or carries into the next type.
+struct EnergyCounts {
+    uint64_t bits = 0;
+
+    static constexpr uint64_t LOW_BITS = 0x0101010101010101ULL;
+    static constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+    int operator[](int type) const { return static_cast<int>((bits >> (8 * type)) & 0xFF); }
+    void add(int type, int amount = 1) { bits += static_cast<uint64_t>(amount) << (8 * type); }
+    void remove(int type, int amount = 1) { bits -= static_cast<uint64_t>(amount) << (8 * type); }
+
+    // Returns the energy of all types: one multiply sums the bytes into the top one.
+    int total() const { return static_cast<int>((bits * LOW_BITS) >> 56); }
+
+    // Returns true if every type has at least as much energy as in `cost`:
+    // setting each byte's top bit before subtracting leaves it set exactly
+    // where no borrow occurred.
+    bool covers(EnergyCounts cost) const { return (((bits | HIGH_BITS) - cost.bits) & HIGH_BITS) == HIGH_BITS; }
+
+    bool operator==(const EnergyCounts &other) const = default;
+};
+
+static_assert(ENERGY_TYPE_COUNT * 8 <= 64, "Every energy type needs a byte of EnergyCounts.");
+
+// Energy cost of a skill.
+struct EnergyCost {
+    EnergyCounts typed;         // Energy of specific types.
+    uint8_t colorless = 0;      // Energy payable with any type.
+    uint8_t total = 0;          // Typed plus Colorless.
+};
+
+// Returns true if attached energy pays for a cost, Colorless included. Takes a
+// constant number of word operations: the typed counts must each be covered,
+// and what remains pays for Colorless exactly when the total is large enough.
+inline bool canPay(EnergyCounts attached, const EnergyCost &cost) {
+    return attached.covers(cost.typed) && attached.total() >= cost.total;
+}
+
+#endif // ENERGY_H
@@ -0,0 +1,124 @@
+// EngineStats.cpp
+#include "EngineStats.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+// Threads beyond this share the last slot; their counts stay correct in total
+// but may lose updates.
+static const int MAX_STATS_THREADS = 256;
+
+static ThreadStats threadSlots[MAX_STATS_THREADS];
+static std::atomic<int> registeredThreads{0};
+static std::atomic<uint64_t> phaseNs[PHASE_COUNT];
+
+// Returns the counters of the calling thread, registering it on first use.
+ThreadStats &registerStatsThread() {
+    int slot = registeredThreads.fetch_add(1, std::memory_order_relaxed);
+    return threadSlots[slot < MAX_STATS_THREADS ? slot : MAX_STATS_THREADS - 1];
+}
+
+// Adds wall time to a phase.
+void addPhaseTime(StatsPhase phase, uint64_t ns) {
+    phaseNs[phase].fetch_add(ns, std::memory_order_relaxed);
+}
+
+double SearchStats::nodesPerSecond() const {
+    double seconds = phaseSeconds[PHASE_SEARCH];
+    return seconds > 0.0 ? counters[COUNTER_NODES] / seconds : 0.0;
+}
+
+double SearchStats::rolloutsPerSecond() const {
+    double seconds = phaseSeconds[PHASE_ROLLOUT];
+    return seconds > 0.0 ? counters[COUNTER_ROLLOUTS] / seconds : 0.0;
+}
+
+double SearchStats::ttHitRate() const {
+    uint64_t probes = counters[COUNTER_TT_PROBES];
+    return probes > 0 ? static_cast<double>(counters[COUNTER_TT_HITS]) / probes : 0.0;
+}
+
+// Returns the statistics collected since program start.
+SearchStats statsSnapshot() {
+    SearchStats stats;
+    int threads = std::min(registeredThreads.load(std::memory_order_relaxed), MAX_STATS_THREADS);
+    stats.threadBusySeconds.resize(threads);
+    for (int t = 0; t < threads; ++t) {
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            stats.counters[c] += threadSlots[t].counters[c].load(std::memory_order_relaxed);
+        }
+        stats.threadBusySeconds[t] = threadSlots[t].busyNs.load(std::memory_order_relaxed) * 1e-9;
+    }
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        stats.phaseSeconds[p] = phaseNs[p].load(std::memory_order_relaxed) * 1e-9;
+    }
+    return stats;
+}
+
+// Returns the statistics collected between `before` and `after`.
+SearchStats statsDifference(const SearchStats &after, const SearchStats &before) {
+    SearchStats stats = after;
+    for (int c = 0; c < COUNTER_COUNT; ++c) stats.counters[c] -= before.counters[c];
+    for (int p = 0; p < PHASE_COUNT; ++p) stats.phaseSeconds[p] -= before.phaseSeconds[p];
+    for (size_t t = 0; t < before.threadBusySeconds.size() && t < stats.threadBusySeconds.size(); ++t) {
+        stats.threadBusySeconds[t] -= before.threadBusySeconds[t];
+    }
+    return stats;
+}
+
+// Prints statistics as a short human-readable report.
+void printStats(std::ostream &out, const SearchStats &stats) {
+    if (!STATS_ENABLED) {
+        out << "Engine statistics are compiled out (build with TCGP_STATS)." << std::endl;
+        return;
+    }
+    static const char *const PHASE_NAMES[PHASE_COUNT] = {"load", "filter", "search", "eval", "rollout"};
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3)
+        << "Nodes: " << stats.nodes() << " (" << std::setprecision(0) << stats.nodesPerSecond() << "/s), "
+        << "TT hits: " << stats.counters[COUNTER_TT_HITS] << "/" << stats.counters[COUNTER_TT_PROBES]
+        << " (" << std::setprecision(1) << stats.ttHitRate() * 100 << "%), "
+        << "evaluations: " << stats.counters[COUNTER_EVALS] << ", "
+        << "rollouts: " << stats.rollouts() << " (" << std::setprecision(0) << stats.rolloutsPerSecond() << "/s)\n";
+    out << "Phase seconds:" << std::setprecision(3);
+    for (int p = 0; p < PHASE_COUNT; ++p) out << " " << PHASE_NAMES[p] << " " << stats.phaseSeconds[p];
+    out << "\nBusy seconds per thread:";
+    for (double busy : stats.threadBusySeconds) out << " " << busy;
+    out << std::endl;
+    out.flags(flags);
+}
+
+// --- Periodic Dump ---
+
+static std::thread dumpThread;
+static std::mutex dumpMutex;
+static std::condition_variable dumpWake;
+static bool dumpStopping = false;
+
+// Starts a background thread that prints the statistics of each interval.
+void startStatsDump(std::ostream &out, int intervalMs) {
+    stopStatsDump();
+    dumpStopping = false;
+    dumpThread = std::thread([&out, intervalMs] {
+        SearchStats last = statsSnapshot();
+        std::unique_lock<std::mutex> lock(dumpMutex);
+        while (!dumpWake.wait_for(lock, std::chrono::milliseconds(intervalMs), [] { return dumpStopping; })) {
+            SearchStats now = statsSnapshot();
+            printStats(out, statsDifference(now, last));
+            last = now;
+        }
+    });
+}
+
+// Stops the periodic report.
+void stopStatsDump() {
+    if (!dumpThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        dumpStopping = true;
+    }
+    dumpWake.notify_all();
+    dumpThread.join();
+}
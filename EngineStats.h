@@ -0,0 +1,153 @@
+// EngineStats.h
+#ifndef ENGINESTATS_H
+#define ENGINESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Engine statistics are collected when the library is built with TCGP_STATS
+// (the CMake option of the same name). Without it every hook below is empty
+// and compiles away.
+#ifdef TCGP_STATS
+constexpr bool STATS_ENABLED = true;
+#else
+constexpr bool STATS_ENABLED = false;
+#endif
+
+// Event counters kept per thread.
+enum StatsCounter {
+    COUNTER_NODES,          // Search nodes visited.
+    COUNTER_TT_PROBES,      // Transposition table lookups.
+    COUNTER_TT_HITS,        // Lookups that found the position.
+    COUNTER_EVALS,          // Static evaluations.
+    COUNTER_ROLLOUTS,       // Monte Carlo rollouts played.
+    COUNTER_COUNT
+};
+
+// Phases whose wall time is accumulated.
+enum StatsPhase {
+    PHASE_LOAD,             // Card database and meta-deck loading.
+    PHASE_FILTER,           // Meta-deck filtering and posterior updates.
+    PHASE_SEARCH,           // Decision tree searches.
+    PHASE_EVAL,             // Static evaluations (sampled; part of the search).
+    PHASE_ROLLOUT,          // Monte Carlo simulations.
+    PHASE_COUNT
+};
+
+// One in EVAL_TIMING_SAMPLE evaluations is timed and stands for the others,
+// so timing costs little next to the evaluation itself.
+const int EVAL_TIMING_SAMPLE = 64;
+
+// Counters of one thread. Only the owning thread writes them, with relaxed
+// load/store pairs that compile to plain increments; other threads may read
+// them at any time.
+struct alignas(64) ThreadStats {
+    std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+    std::atomic<uint64_t> busyNs{0};            // Time spent searching subtrees.
+};
+
+// Returns the counters of the calling thread, registering it on first use.
+ThreadStats &registerStatsThread();
+
+inline ThreadStats &threadStats() {
+    thread_local ThreadStats &stats = registerStatsThread();
+    return stats;
+}
+
+// Adds to a counter of the calling thread.
+// Returns:
+// - The new value of the counter.
+inline uint64_t countStat(StatsCounter counter, uint64_t amount = 1) {
+    if constexpr (STATS_ENABLED) {
+        std::atomic<uint64_t> &c = threadStats().counters[counter];
+        uint64_t value = c.load(std::memory_order_relaxed) + amount;
+        c.store(value, std::memory_order_relaxed);
+        return value;
+    }
+    return 0;
+}
+
+// Adds wall time to a phase.
+void addPhaseTime(StatsPhase phase, uint64_t ns);
+
+// Measures the lifetime of a scope and adds it, times `weight`, to a phase.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(StatsPhase phase, uint64_t weight = 1) : phase_(phase), weight_(weight) {
+        if constexpr (STATS_ENABLED) start_ = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if constexpr (STATS_ENABLED) addPhaseTime(phase_, elapsedNs(start_) * weight_);
+    }
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+    static uint64_t elapsedNs(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    StatsPhase phase_;
+    uint64_t weight_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Measures the lifetime of a scope as busy time of the calling thread.
+class BusyTimer {
+public:
+    BusyTimer() {
+        if constexpr (STATS_ENABLED) start_ = std::chrono::steady_clock::now();
+    }
+    ~BusyTimer() {
+        if constexpr (STATS_ENABLED) {
+            std::atomic<uint64_t> &busy = threadStats().busyNs;
+            busy.store(busy.load(std::memory_order_relaxed) + PhaseTimer::elapsedNs(start_),
+                       std::memory_order_relaxed);
+        }
+    }
+    BusyTimer(const BusyTimer &) = delete;
+    BusyTimer &operator=(const BusyTimer &) = delete;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Totals of the engine statistics. A snapshot holds the totals since program
+// start; the difference of two snapshots covers the work in between, including
+// work of concurrent searches.
+struct SearchStats {
+    uint64_t counters[COUNTER_COUNT] = {};
+    double phaseSeconds[PHASE_COUNT] = {};
+    std::vector<double> threadBusySeconds;      // Per registered thread.
+
+    uint64_t nodes() const { return counters[COUNTER_NODES]; }
+    uint64_t rollouts() const { return counters[COUNTER_ROLLOUTS]; }
+    double nodesPerSecond() const;
+    double rolloutsPerSecond() const;
+    double ttHitRate() const;
+};
+
+// Returns the statistics collected since program start.
+SearchStats statsSnapshot();
+
+// Returns the statistics collected between `before` and `after`.
+SearchStats statsDifference(const SearchStats &after, const SearchStats &before);
+
+// Prints statistics as a short human-readable report.
+void printStats(std::ostream &out, const SearchStats &stats);
+
+// Starts a background thread that prints the statistics collected in each
+// interval until stopStatsDump() is called.
+// Parameters:
+// - out: The stream to print to.
+// - intervalMs: Milliseconds between reports.
+void startStatsDump(std::ostream &out, int intervalMs);
+
+// Stops the periodic report started by startStatsDump().
+void stopStatsDump();
+
+#endif // ENGINESTATS_H
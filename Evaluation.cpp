@@ -0,0 +1,136 @@
+// Evaluation.cpp
+#include "Evaluation.h"
+#include "CardRegistry.h"
+#include "Constants.h"
+#include "EngineStats.h"
+#include <algorithm>
+#include <cmath>
+
+// Weights of the evaluation terms, in logits of win probability.
+static const float W_POINTS = 1.2f;        // Per prize point scored.
+static const float W_HP = 0.4f;            // Per Pokémon in play at full HP.
+static const float W_ACTIVE_HP = 0.3f;     // Extra weight of the Active Pokémon's HP.
+static const float W_PRIZE_RISK = 0.35f;   // Per prize point a Pokémon gives up, scaled by HP lost.
+static const float W_ENERGY = 0.4f;        // Active Pokémon's best skill fully paid.
+static const float W_BENCH_ENERGY = 0.1f;  // A benched Pokémon's best skill fully paid.
+static const float W_POISON = 0.2f;        // Poisoned Active Pokémon.
+static const float W_PARALYSIS = 0.4f;     // Paralyzed Active Pokémon.
+static const float W_BENCH = 0.25f;        // Per benched Pokémon.
+static const float W_WEAKNESS = 0.3f;      // Active Pokémon hits the opposing Active for weakness.
+static const float W_THREAT = 0.6f;        // Active Pokémon can knock out the opposing Active.
+
+// Number of board slots across both sides.
+const int EVAL_SLOTS = 2 * (MAX_BENCH + 1);
+
+// Returns the fraction of a skill's cost paid by the energy attached to a slot.
+static float paidFraction(const SlotState &slot, const SkillData &skill) {
+    const int needed = skill.cost.total;
+    if (canPay(slot.energy, skill.cost)) return 1.0f;
+    int paid = 0;
+    int spare = 0;
+    for (int i = 0; i < ENERGY_TYPE_COUNT; ++i) {
+        paid += std::min(slot.energy[i], skill.cost.typed[i]);
+        spare += std::max(0, slot.energy[i] - skill.cost.typed[i]);
+    }
+    paid += std::min<int>(spare, skill.cost.colorless);
+    return static_cast<float>(paid) / needed;
+}
+
+// Returns how close a slot is to paying for its most affordable skill, from 0 to 1.
+static float energyReadiness(const CardTable &table, const SlotState &slot) {
+    const CardData &card = table[slot.card];
+    float best = 0.0f;
+    for (int i = 0; i < card.skillCount; ++i) best = std::max(best, paidFraction(slot, card.skills[i]));
+    return best;
+}
+
+// Returns the fraction of the defender's HP the attacker's best usable skill
+// is expected to take, capped at 1.
+static float knockoutThreat(const CardTable &table, const SlotState &attacker, const SlotState &defender) {
+    if (attacker.card == NO_CARD || defender.card == NO_CARD || defender.hp <= 0) return 0.0f;
+    if (attacker.status & STATUS_PARALYZED) return 0.0f;
+    const CardData &card = table[attacker.card];
+    double best = 0.0;
+    for (int i = 0; i < card.skillCount; ++i) {
+        if (canAfford(attacker, card.skills[i])) {
+            best = std::max(best, expectedSkillDamage(table, card.skills[i], attacker, defender));
+        }
+    }
+    return static_cast<float>(std::min(1.0, best / defender.hp));
+}
+
+// Scores the terms of one side that do not depend on HP.
+static float sideScore(const CardTable &table, const SideState &me, const SideState &opp) {
+    float score = W_POINTS * me.points + W_BENCH * me.benchCount;
+    if (me.active.card == NO_CARD) return score;
+
+    score += W_ENERGY * energyReadiness(table, me.active);
+    for (int i = 0; i < me.benchCount; ++i) score += W_BENCH_ENERGY * energyReadiness(table, me.bench[i]);
+    score -= W_POISON * ((me.active.status & STATUS_POISONED) != 0);
+    score -= W_PARALYSIS * ((me.active.status & STATUS_PARALYZED) != 0);
+    score += W_WEAKNESS * isWeakTo(table, opp.active, me.active);
+    score += W_THREAT * knockoutThreat(table, me.active, opp.active);
+    return score;
+}
+
+// Evaluates a compact search state without statistics.
+static double evaluateUncounted(const SearchState &state, const CardTable &table) {
+    // HP terms of all Pokémon in play, laid out as flat arrays so that the
+    // sum runs as one SIMD loop: a slot adds scale * (hp / maxHp) + offset.
+    alignas(32) float hp[EVAL_SLOTS] = {};
+    alignas(32) float maxHp[EVAL_SLOTS];
+    alignas(32) float scale[EVAL_SLOTS] = {};
+    alignas(32) float offset[EVAL_SLOTS] = {};
+    std::fill(maxHp, maxHp + EVAL_SLOTS, 1.0f);
+
+    for (int s = 0; s < 2; ++s) {
+        const SideState &side = state.sides[s];
+        float sign = (s == 0) ? 1.0f : -1.0f;
+        for (int j = 0; j <= side.benchCount; ++j) {
+            const SlotState &slot = (j == 0) ? side.active : side.bench[j - 1];
+            if (slot.card == NO_CARD) continue;
+            const CardData &card = table[slot.card];
+            float prize = card.isEx ? 2.0f : 1.0f;
+            int k = s * (MAX_BENCH + 1) + j;
+            hp[k] = std::max<float>(0.0f, slot.hp);
+            maxHp[k] = std::max<float>(1.0f, card.hp);
+            scale[k] = sign * (W_HP + (j == 0 ? W_ACTIVE_HP : 0.0f) + W_PRIZE_RISK * prize);
+            offset[k] = -sign * W_PRIZE_RISK * prize;
+        }
+    }
+
+    float material = 0.0f;
+    #pragma omp simd reduction(+:material)
+    for (int k = 0; k < EVAL_SLOTS; ++k) {
+        material += scale[k] * (hp[k] / maxHp[k]) + offset[k];
+    }
+
+    float advantage = material + sideScore(table, state.sides[0], state.sides[1]) -
+                      sideScore(table, state.sides[1], state.sides[0]);
+    return 1.0 / (1.0 + std::exp(-static_cast<double>(advantage)));
+}
+
+// Evaluates a compact search state.
+double evaluateSearchState(const SearchState &state, const CardTable &table) {
+    if (countStat(COUNTER_EVALS) % EVAL_TIMING_SAMPLE == 0) {
+        PhaseTimer timer(PHASE_EVAL, EVAL_TIMING_SAMPLE);
+        return evaluateUncounted(state, table);
+    }
+    return evaluateUncounted(state, table);
+}
+
+// Fingerprints the evaluation's version and weights.
+uint64_t evaluationFingerprint() {
+    struct {
+        uint32_t version;
+        float weights[11];
+    } fields = {EVALUATION_VERSION,
+                {W_POINTS, W_HP, W_ACTIVE_HP, W_PRIZE_RISK, W_ENERGY, W_BENCH_ENERGY,
+                 W_POISON, W_PARALYSIS, W_BENCH, W_WEAKNESS, W_THREAT}};
+    return imageChecksum(reinterpret_cast<const char *>(&fields), sizeof(fields));
+}
+
+// Evaluates the game state.
+double evaluateGameState(const GameState &state, int /*depth*/) {
+    return evaluateSearchState(toSearchState(state), state.cards->table());
+}
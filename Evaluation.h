@@ -0,0 +1,38 @@
+// Evaluation.h
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "PokemonCard.h"
+#include "SearchState.h"
+#include <cstdint>
+
+// Version of the search state evaluation. Bump when its terms change, so that
+// cached search values computed with the old heuristic are not reused.
+const uint32_t EVALUATION_VERSION = 1;
+
+// Evaluates the game state and returns a value between 0.0 and 1.0.
+// This function is used to assess the current state of the game.
+// Parameters:
+// - state: The current game state to evaluate.
+// - depth: Optional parameter to specify the depth of evaluation (default is 0).
+// Returns:
+// - The estimated probability that the player wins.
+double evaluateGameState(const GameState &state, int depth = 0);
+
+// Evaluates a compact search state and returns a value between 0.0 and 1.0.
+// The evaluation is deterministic: a weighted sum of prize points, HP left
+// (EX Pokémon put 2 points at risk), energy attached against skill costs,
+// status conditions, bench depth, weakness and knockout threat, compared
+// between both sides and mapped to (0, 1) with a logistic curve.
+// Parameters:
+// - state: The search state to evaluate.
+// - table: The card table the state refers to.
+// Returns:
+// - The estimated probability that side 0 wins.
+double evaluateSearchState(const SearchState &state, const CardTable &table);
+
+// Returns a fingerprint of evaluateSearchState: EVALUATION_VERSION and the
+// term weights.
+uint64_t evaluationFingerprint();
+
+#endif // EVALUATION_H
@@ -1,265 +1,397 @@
 // FileParser.cpp
 #include "FileParser.h"
 #include "Utils.h"
+#include "EngineStats.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <cctype>
 #include <string>
 #include <omp.h>
+#include <filesystem>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+// Reads a whole file into one buffer.
+// Parameters:
+// - filename: The file to read.
+// - buffer: Output, the file contents.
+// Returns:
+// - True if the file was read.
+bool readWholeFile(const std::string &filename, std::string &buffer) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())));
+}
 
 // Parses an integer from a string, returning 0 if parsing fails.
 // Parameters:
 // - raw: The string to parse.
 // Returns:
 // - The parsed integer, or 0 if parsing fails.
-int parseIntOrZero(const std::string &raw) {
-    std::string s = trim(raw);
+int parseIntOrZero(std::string_view raw) {
+    std::string_view s = trimView(raw);
     // Remove any trailing non-digit characters.
     while (!s.empty() && !isdigit(static_cast<unsigned char>(s.back()))) {
-        s.pop_back();
+        s.remove_suffix(1);
     }
-    if (s.empty()) return 0;
-    try {
-        return std::stoi(s);
-    } catch (...) {
-        return 0;
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    int value = 0;
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return (result.ec == std::errc()) ? value : 0;
+}
+
+// --- SkillEffect Tokens ---
+
+// Applies a recognized SkillEffect token; `arg` is the text after the pattern.
+using SkillEffectHandler = void (*)(SpecialSkill &effect, std::string_view arg);
+
+// A SkillEffect token pattern: an exact token or a prefix followed by an argument.
+struct SkillEffectRule {
+    std::string_view pattern;
+    bool prefix;
+    SkillEffectHandler apply;
+};
+
+static void flipToParalyze(SpecialSkill &effect, std::string_view) {
+    effect.doCoinFlips = true;
+    effect.numFlips = 1;
+    effect.paralyzeOpp = true;
+}
+
+static void flipToShuffleBack(SpecialSkill &effect, std::string_view) {
+    effect.doCoinFlips = true;
+    effect.numFlips = 1;
+    effect.shuffleOpponentBackIfHeads = true;
+}
+
+static void parseRandomHits(SpecialSkill &effect, std::string_view arg) {
+    std::string_view damage = nextToken(arg, ',');
+    std::string_view count = nextToken(arg, ',');
+    if (!count.empty() && arg.empty()) {
+        effect.randomHitDamage = parseIntOrZero(damage); // Parse random hit damage.
+        effect.randomHitCount = parseIntOrZero(count);   // Parse random hit count.
     }
 }
 
+// Recognized tokens, checked in order: exact tokens that share a prefix with a
+// prefix rule must come first.
+static const SkillEffectRule SKILL_EFFECT_RULES[] = {
+    {"None", false, [](SpecialSkill &, std::string_view) {}},
+    {"Heal:", true, [](SpecialSkill &e, std::string_view arg) { e.heal = parseIntOrZero(arg); }},
+    {"CoinFlip:ParalyzeOpp", false, flipToParalyze},
+    {"CoinFlip:paralyzeOpp", false, flipToParalyze},
+    {"CoinFlip:", true, [](SpecialSkill &e, std::string_view arg) {
+        e.doCoinFlips = true;
+        e.damagePerFlip = parseIntOrZero(arg); // Parse damage per flip.
+    }},
+    {"ShuffleBackIfHeads", false, flipToShuffleBack},
+    {"shuffleBack", false, flipToShuffleBack},
+    {"DamagePerEnergy:", true, [](SpecialSkill &e, std::string_view arg) { e.damagePerEnergyAttached = parseIntOrZero(arg); }},
+    {"energyAttached:", true, [](SpecialSkill &e, std::string_view arg) { e.damagePerEnergyAttached = parseIntOrZero(arg); }},
+    {"randomDmg:", true, parseRandomHits},
+    {"PoisonOpp", false, [](SpecialSkill &e, std::string_view) { e.poisonOpp = true; }},
+    {"poisonOpp", false, [](SpecialSkill &e, std::string_view) { e.poisonOpp = true; }},
+    {"switchOut", false, [](SpecialSkill &e, std::string_view) { e.switchOutOpp = true; }},
+    {"banSupporter", false, [](SpecialSkill &e, std::string_view) { e.banSupporter = true; }},
+    {"BanSupporter:nextTurn", false, [](SpecialSkill &e, std::string_view) { e.banSupporter = true; }},
+    {"dmgIfPoisoned:", true, [](SpecialSkill &e, std::string_view arg) { e.extraDmgIfPoisoned = parseIntOrZero(arg); }},
+    {"reduceDmg:", true, [](SpecialSkill &e, std::string_view arg) { e.damageReduction = parseIntOrZero(arg); }},
+    {"benchedDmg:", true, [](SpecialSkill &e, std::string_view arg) { e.benchedDamage = parseIntOrZero(arg); }},
+    {"BenchedDmg:", true, [](SpecialSkill &e, std::string_view arg) { e.benchedDamage = parseIntOrZero(arg); }},
+    // The energy dropped is the energy drop field of the Skills line.
+    {"dropEnergy:", true, [](SpecialSkill &, std::string_view) {}},
+};
+
 // Parses a single SkillEffect token into a SpecialSkill structure.
 // Parameters:
 // - token: The string token representing the skill effect.
 // - effect: The SpecialSkill structure to populate with the parsed effect.
-void applySkillEffectToken(const std::string &token, SpecialSkill &effect) {
-    if (token == "None") return;
-
-    if (token.rfind("Heal:", 0) == 0) {
-        effect.heal = parseIntOrZero(token.substr(5)); // Parse Heal amount.
-    } else if (token.rfind("CoinFlip:", 0) == 0) {
-        effect.doCoinFlips = true;
-        effect.damagePerFlip = parseIntOrZero(token.substr(9)); // Parse damage per flip.
-    } else if (token == "CoinFlip:ParalyzeOpp") {
-        effect.doCoinFlips = true;
-        effect.numFlips = 1;
-        effect.paralyzeOpp = true;
-    } else if (token == "ShuffleBackIfHeads") {
-        effect.doCoinFlips = true;
-        effect.numFlips = 1;
-        effect.shuffleOpponentBackIfHeads = true;
-    } else if (token.rfind("DamagePerEnergy:", 0) == 0 || token.rfind("energyAttached:", 0) == 0) {
-        auto sep = token.find(':');
-        effect.damagePerEnergyAttached = parseIntOrZero(token.substr(sep + 1)); // Parse damage per energy.
-    } else if (token.rfind("randomDmg:", 0) == 0) {
-        auto parts = splitAndTrim(token.substr(10), ',');
-        if (parts.size() == 2) {
-            effect.randomHitDamage = parseIntOrZero(parts[0]); // Parse random hit damage.
-            effect.randomHitCount = parseIntOrZero(parts[1]);  // Parse random hit count.
+void applySkillEffectToken(std::string_view token, SpecialSkill &effect) {
+    for (const SkillEffectRule &rule : SKILL_EFFECT_RULES) {
+        if (rule.prefix ? token.substr(0, rule.pattern.size()) == rule.pattern : token == rule.pattern) {
+            rule.apply(effect, token.substr(rule.pattern.size()));
+            return;
         }
-    } else if (token == "PoisonOpp") {
-        effect.poisonOpp = true;
-    } else if (token == "switchOut") {
-        effect.switchOutOpp = true;
-    } else if (token == "banSupporter" || token == "BanSupporter:nextTurn") {
-        effect.banSupporter = true;
-    } else if (token.rfind("dmgIfPoisoned:", 0) == 0) {
-        effect.extraDmgIfPoisoned = parseIntOrZero(token.substr(14)); // Parse extra damage if poisoned.
-    } else if (token.rfind("reduceDmg:", 0) == 0) {
-        effect.damageReduction = parseIntOrZero(token.substr(10)); // Parse damage reduction.
-    } else if (token.rfind("benchedDmg:", 0) == 0) {
-        effect.benchedDamage = parseIntOrZero(token.substr(11)); // Parse benched damage.
+    }
+    std::cerr << "Warning: Unrecognized SkillEffect token: " << token << std::endl;
+}
+
+// Folds the coin settings from the Skills line into the skill's SpecialSkill,
+// so simulations only need to read the effect.
+// "CoinFlip:<dmg>" with a positive flip count flips that many coins; without one
+// (e.g. "MAX_FLIP") it flips until tails.
+// Parameters:
+// - skill: The skill whose effect is completed.
+void finalizeCoinFlips(Skill &skill) {
+    SpecialSkill &effect = skill.specialEffect;
+    if (!effect.doCoinFlips || effect.numFlips > 0 || effect.flipUntilTails) return;
+    if (skill.maxFlip > 0) {
+        effect.numFlips = skill.maxFlip;
     } else {
-        std::cerr << "Warning: Unrecognized SkillEffect token: " << token << std::endl;
+        effect.flipUntilTails = true;
     }
 }
 
-// Parses a Pokémon block from the input stream.
+// --- Pokémon Block Fields ---
+
+// Applies the value of one "Key: value" line of a Pokémon block.
+using PokemonFieldHandler = void (*)(Pokemon &p, std::string_view value);
+
+struct PokemonField {
+    std::string_view key;
+    PokemonFieldHandler apply;
+};
+
+// Returns the value as a string, or an empty string for "None".
+static std::string noneToEmpty(std::string_view value) {
+    return (value == "None") ? std::string() : std::string(value);
+}
+
+// Parses "Name,Damage,Energy,EnergyDrop,FlipCoin,MaxFlips" skills separated by ';'.
+static void parseSkills(Pokemon &p, std::string_view value) {
+    while (!value.empty()) {
+        std::string_view rest = nextToken(value, ';');
+        std::string_view fields[6];
+        int count = 0;
+        while (!rest.empty() && count < 6) fields[count++] = nextToken(rest, ',');
+        if (count < 6) continue;
+
+        Skill s(
+            std::string(fields[0]),
+            parseIntOrZero(fields[1]),                // Damage.
+            parseIntOrZero(fields[3]),                // Energy drop.
+            equalsIgnoreCase(fields[4], "true"),      // Flip coin.
+            parseIntOrZero(fields[5])                 // Max flips.
+        );
+        // Parse energy requirements.
+        std::string_view energy = fields[2];
+        while (!energy.empty()) {
+            std::string_view enToken = nextToken(energy, '|');
+            size_t pos = enToken.find(':');
+            if (pos != std::string_view::npos) {
+                s.energyRequirements.emplace_back(std::string(trimView(enToken.substr(0, pos))),
+                                                  parseIntOrZero(enToken.substr(pos + 1)));
+            }
+        }
+        p.skills.push_back(std::move(s));
+    }
+}
+
+// Applies SkillEffect tokens: one token per skill when the counts line up,
+// otherwise everything applies to the last skill.
+static void parseSkillEffects(Pokemon &p, std::string_view value) {
+    if (p.skills.empty()) return;
+    size_t tokens = 0;
+    for (std::string_view rest = value; !rest.empty(); nextToken(rest, ';')) ++tokens;
+    bool positional = (tokens == p.skills.size());
+    for (size_t i = 0; !value.empty(); ++i) {
+        Skill &skill = positional ? p.skills[i] : p.skills.back();
+        applySkillEffectToken(nextToken(value, ';'), skill.specialEffect);
+    }
+    for (auto &skill : p.skills) {
+        finalizeCoinFlips(skill);
+    }
+}
+
+// Parses "Name|Description" abilities separated by ';'. "None" means no ability.
+static void parseAbilities(Pokemon &p, std::string_view value) {
+    while (!value.empty()) {
+        std::string_view rest = nextToken(value, ';');
+        if (rest.empty()) continue;
+        std::string_view name = nextToken(rest, '|');
+        std::string_view desc = nextToken(rest, '|');
+        if (equalsIgnoreCase(name, "none")) continue;
+        p.abilities.emplace_back(std::string(name), std::string(desc));
+    }
+}
+
+static const PokemonField POKEMON_FIELDS[] = {
+    {"Name", [](Pokemon &p, std::string_view v) { p.name = noneToEmpty(v); }},
+    {"ex", [](Pokemon &p, std::string_view v) { p.isEx = equalsIgnoreCase(v, "true"); }},
+    {"Type", [](Pokemon &p, std::string_view v) {
+        p.type = std::string(v);
+        if (v == "Supporter")        p.cardType = 1;
+        else if (v == "Item")        p.cardType = 2;
+        else /* Pokémon */           p.cardType = 0;
+    }},
+    {"Package", [](Pokemon &p, std::string_view v) { p.package = std::string(v); }},
+    {"CanEvolve", [](Pokemon &p, std::string_view v) { p.canEvolve = equalsIgnoreCase(v, "true"); }},
+    {"CardType", [](Pokemon &p, std::string_view v) { p.cardType = parseIntOrZero(v); }},
+    {"HP", [](Pokemon &p, std::string_view v) { p.hp = parseIntOrZero(v); }},
+    {"Stage", [](Pokemon &p, std::string_view v) {
+        p.stage = parseIntOrZero(v);
+        if (p.stage != 0) p.canEvolve = false;
+    }},
+    {"Weakness", [](Pokemon &p, std::string_view v) { p.weakness = noneToEmpty(v); }},
+    {"RetreatCost", [](Pokemon &p, std::string_view v) { p.retreatCost = parseIntOrZero(v); }},
+    {"PrevEvo", [](Pokemon &p, std::string_view v) { p.prevEvo = noneToEmpty(v); }},
+    {"NextEvo", [](Pokemon &p, std::string_view v) { p.nextEvo = noneToEmpty(v); }},
+    {"Skills", parseSkills},
+    {"SkillEffect", parseSkillEffects},
+    {"Abilities", parseAbilities},
+};
+
+// Parses a Pokémon block from the text that follows its BEGIN_POKEMON line.
+// A block that runs into the next BEGIN_POKEMON without an END_POKEMON line is
+// closed there, with a warning.
 // Parameters:
-// - in: The input stream containing the Pokémon data.
+// - text: The remaining file text; advanced past the block.
 // - p: The Pokémon object to populate with the parsed data.
 // Returns:
 // - True if the Pokémon block was successfully parsed, false otherwise.
-bool parsePokemonBlock(std::istream &in, Pokemon &p) {
-    std::string line;
-    while (std::getline(in, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
+bool parsePokemonBlock(std::string_view &text, Pokemon &p) {
+    std::string_view line;
+    std::string_view before = text;
+    while (nextLine(text, line)) {
+        line = trimView(line);
+        if (line.empty()) {
+            before = text;
+            continue;
+        }
         if (line == "END_POKEMON") return true;
+        if (line == "BEGIN_POKEMON") {
+            std::cerr << "Warning: Missing END_POKEMON after " << p.name << std::endl;
+            text = before;
+            return true;
+        }
+        before = text;
 
         auto delimPos = line.find(':');
-        if (delimPos == std::string::npos) continue;
-        std::string key = trim(line.substr(0, delimPos));
-        std::string value = trim(line.substr(delimPos + 1));
-
-        if (key == "Name") {
-            p.name = (value == "None" ? "" : value);
-        } else if (key == "ex") {
-            p.isEx = (toLower(value) == "true");
-        } else if (key == "Type") {
-            p.type = value;
-            if (value == "Supporter")        p.cardType = 1;
-            else if (value == "Item")        p.cardType = 2;
-            else /* Pokémon */               p.cardType = 0;
-        } else if (key == "Package") {
-            p.package = value;
-        } else if (key == "CanEvolve") {
-            p.canEvolve = (toLower(value) == "true");
-        } else if (key == "CardType") {
-            p.cardType = parseIntOrZero(value); // Parse CardType.
-        } else if (key == "HP") {
-            p.hp = parseIntOrZero(value); // Parse HP.
-        } else if (key == "Stage") {
-            p.stage = parseIntOrZero(value); // Parse Stage.
-            if (p.stage != 0) p.canEvolve = false;
-        } else if (key == "Weakness") {
-            p.weakness = (value == "None" ? "" : value);
-        } else if (key == "RetreatCost") {
-            p.retreatCost = parseIntOrZero(value); // Parse RetreatCost.
-        } else if (key == "PrevEvo") {
-            p.prevEvo = (value == "None" ? "" : value);
-        } else if (key == "NextEvo") {
-            p.nextEvo = (value == "None" ? "" : value);
-        } else if (key == "Skills") {
-            auto skillTokens = splitAndTrim(value, ';');
-            for (auto &skillToken : skillTokens) {
-                auto tokens = splitAndTrim(skillToken, ',');
-                if (tokens.size() < 6) continue;
-                Skill s(
-                    tokens[0],
-                    parseIntOrZero(tokens[1]),        // Damage.
-                    parseIntOrZero(tokens[3]),        // Energy drop.
-                    (toLower(tokens[4]) == "true"),   // Flip coin.
-                    parseIntOrZero(tokens[5])         // Max flips.
-                );
-                // Parse energy requirements.
-                for (auto &enToken : splitAndTrim(tokens[2], '|')) {
-                    auto pos = enToken.find(':');
-                    if (pos != std::string::npos) {
-                        s.energyRequirements.emplace_back(
-                            trim(enToken.substr(0, pos)),
-                            parseIntOrZero(trim(enToken.substr(pos + 1)))
-                        );
-                    }
-                }
-                p.skills.push_back(std::move(s));
-            }
-        } else if (key == "SkillEffect") {
-            if (p.skills.empty()) continue;
-            auto &effect = p.skills.back().specialEffect;
-            for (auto &tok : splitAndTrim(value, ';')) {
-                applySkillEffectToken(trim(tok), effect);
-            }
-        } else if (key == "Abilities") {
-            // Split multiple abilities by ';'
-            for (auto &tok : splitAndTrim(value, ';')) {
-                auto parts = splitAndTrim(tok, '|');
-                if (parts.empty()) continue;
-                // "None" means no ability
-                if (toLower(parts[0]) == "none") 
-                    continue;
-
-                // parts[0] = ability name, parts[1] (if present) = description
-                const std::string &name = parts[0];
-                const std::string  desc = (parts.size() > 1 ? parts[1] : "");
-                p.abilities.emplace_back(name, desc);
+        if (delimPos == std::string_view::npos) continue;
+        std::string_view key = trimView(line.substr(0, delimPos));
+        std::string_view value = trimView(line.substr(delimPos + 1));
+
+        for (const PokemonField &field : POKEMON_FIELDS) {
+            if (field.key == key) {
+                field.apply(p, value);
+                break;
             }
         }
     }
     return false;
 }
 
-void processEnergyRequirements(std::vector<Skill> &skills) {
-    #pragma omp parallel for
-    for (size_t i = 0; i < skills.size(); ++i) {
-        Skill &skill = skills[i];
-        for (auto &req : skill.energyRequirements) {
-            // Process each energy requirement
-            if (req.amount <= 0) {
-                std::cerr << "Warning: Invalid energy amount for skill: " << skill.skillName << std::endl;
+// Splits a file buffer into chunks that each start at a block marker line.
+// Parameters:
+// - text: The whole file.
+// - marker: The line that opens a block, e.g. BEGIN_POKEMON.
+// - chunkBytes: Approximate size of a chunk.
+// Returns:
+// - The start offset of every chunk, followed by text.size().
+std::vector<size_t> splitIntoBlockChunks(std::string_view text, std::string_view marker, size_t chunkBytes) {
+    std::vector<size_t> bounds{0};
+    size_t chunks = text.size() / std::max<size_t>(chunkBytes, 1) + 1;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t pos = text.size() / chunks * c;
+        if (pos <= bounds.back()) continue;
+        // Move forward to the next line that is exactly the marker.
+        size_t lineStart = text.find('\n', pos);
+        while (lineStart != std::string_view::npos) {
+            ++lineStart;
+            std::string_view rest = text.substr(lineStart);
+            std::string_view line;
+            if (!nextLine(rest, line)) break;
+            if (trimView(line) == marker) {
+                bounds.push_back(lineStart);
+                break;
             }
+            lineStart = text.find('\n', lineStart);
         }
     }
+    bounds.push_back(text.size());
+    return bounds;
 }
 
-// Loads Pokémon card data from a file into the card map.
-// Parameters:
-// - filename: The file containing the Pokémon card data.
-// - cardMap: The map to populate with the loaded Pokémon cards.
-void loadCardMapFromFile(
-    const std::string &filename,
-    std::unordered_map<std::string, Pokemon> &cardMap
-) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open card file: " << filename << std::endl;
-        return;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (trim(line) == "BEGIN_POKEMON") {
+// Parses the Pokémon blocks that start in [begin, end) of the file. The last
+// block may run past `end` up to its END_POKEMON line.
+static void parseCardChunk(std::string_view text, size_t begin, size_t end, std::vector<Pokemon> &cards) {
+    std::string_view rest = text.substr(begin);
+    std::string_view line;
+    while (!rest.empty() && static_cast<size_t>(rest.data() - text.data()) < end) {
+        nextLine(rest, line);
+        if (trimView(line) == "BEGIN_POKEMON") {
             Pokemon p;
-            if (parsePokemonBlock(file, p)) {
-                cardMap[normalize(p.name)] = p; // Normalize key to lowercase and remove spaces.
+            if (parsePokemonBlock(rest, p)) {
+                cards.push_back(std::move(p));
             }
         }
     }
 }
 
-// Loads a deck from a file into a vector of Pokémon.
+// Loads Pokémon card data from a file into the card registry.
 // Parameters:
-// - filename: The file containing the deck data.
-// - deck: The vector to populate with the loaded deck.
-// - cardMap: A map of card names to their corresponding Pokémon objects.
-void loadDeckFromFile(const std::string &filename, std::vector<Pokemon> &deck, const std::unordered_map<std::string, Pokemon> &cardMap) {
-    // Open the file
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Error: Could not open file " + filename);
+// - filename: The file containing the Pokémon card data.
+// - registry: The registry to populate with the loaded Pokémon cards.
+void loadCardRegistryFromFile(const std::string &filename, CardRegistry &registry) {
+    PhaseTimer timer(PHASE_LOAD);
+    std::string buffer;
+    if (!readWholeFile(filename, buffer)) {
+        std::cerr << "Error: Cannot open card file: " << filename << std::endl;
+        return;
     }
 
-    std::string cardName;
-    while (std::getline(file, cardName)) {
-        // Trim leading and trailing whitespace
-        cardName = trim(cardName);
-        std::cout << "Looking for card: " << cardName << std::endl; // Debugging line
-
-        // Normalize the card name
-        std::string normalizedCardName = normalize(cardName);
-        auto it = cardMap.find(normalizedCardName); // Normalize input to lowercase
-        if (it != cardMap.end()) {
-            deck.push_back(it->second); // Add the card to the deck
-        } else {
-            std::cerr << "Warning: Card \"" << cardName << "\" not found in cardMap. Skipping.\n";
-        }
+    // Chunks are parsed in parallel into their own buffers and added in file
+    // order, so duplicates resolve exactly as in a sequential load.
+    std::string_view text(buffer);
+    std::vector<size_t> bounds = splitIntoBlockChunks(text, "BEGIN_POKEMON", LOAD_CHUNK_BYTES);
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    std::vector<std::vector<Pokemon>> parsed(chunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < chunks; ++c) {
+        parseCardChunk(text, bounds[c], bounds[c + 1], parsed[c]);
     }
 
-    // Close the file
-    file.close();
+    for (auto &cards : parsed) {
+        for (auto &p : cards) registry.add(std::move(p));
+    }
+    registry.finalize();
 }
 
-// Loads the entire card database from a file into the card map.
+// Loads the card registry from a binary card image if it is up to date,
+// otherwise from the text card file.
 // Parameters:
-// - filename: The file containing the card database.
-// - cardMap: The map to populate with the loaded card data.
-void loadCardDatabase(const std::string &filename, std::unordered_map<std::string, Pokemon> &cardMap) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open card database file: " << filename << std::endl;
-        return;
+// - textFile: The text card file.
+// - imageFile: The binary card image compiled from it.
+// - registry: The registry to populate.
+void loadCardRegistry(const std::string &textFile, const std::string &imageFile, CardRegistry &registry) {
+    std::error_code error;
+    bool haveImage = std::filesystem::exists(imageFile, error);
+    bool haveText = std::filesystem::exists(textFile, error);
+    if (haveImage && haveText &&
+        std::filesystem::last_write_time(imageFile, error) < std::filesystem::last_write_time(textFile, error)) {
+        std::cerr << "Warning: " << imageFile << " is older than " << textFile << "; parsing the text file." << std::endl;
+        haveImage = false;
     }
+    if (haveImage && registry.loadImage(imageFile)) return;
+    loadCardRegistryFromFile(textFile, registry);
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        line = trim(line);
-        if (line.empty()) continue;
+// Loads a deck from a file into a vector of card IDs.
+// Parameters:
+// - filename: The file containing the deck data.
+// - deck: The vector to populate with the loaded deck.
+// - registry: The card registry to resolve card names against.
+void loadDeckFromFile(const std::string &filename, std::vector<CardId> &deck, const CardRegistry &registry) {
+    std::string buffer;
+    if (!readWholeFile(filename, buffer)) {
+        throw std::runtime_error("Error: Could not open file " + filename);
+    }
 
-        if (line == "BEGIN_POKEMON") {
-            Pokemon p;
-            if (parsePokemonBlock(file, p)) {
-                cardMap[normalize(p.name)] = p; // Normalize key to lowercase and remove spaces
-            }
+    std::string_view text(buffer);
+    std::string_view line;
+    while (nextLine(text, line)) {
+        std::string_view cardName = trimView(line);
+        if (cardName.empty()) continue;
+        CardId id = registry.find(cardName);
+        if (id != NO_CARD) {
+            deck.push_back(id); // Add the card to the deck
+        } else {
+            std::cerr << "Warning: Card \"" << cardName << "\" not found in the card registry. Skipping.\n";
         }
     }
-
-    file.close();
 }
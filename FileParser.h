@@ -2,13 +2,29 @@
 #ifndef FILEPARSER_H
 #define FILEPARSER_H
 
-#include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "PokemonCard.h"
+#include "CardRegistry.h"
 #include "Utils.h" // Include Utils.h to use normalize and other utility functions
 
-// Loads Pokémon card data from a file into the cardMap.
-void loadCardMapFromFile(const std::string &filename, std::unordered_map<std::string, Pokemon> &cardMap);
-int parseIntOrZero(const std::string &raw);
+// Loads Pokémon card data from a file into the card registry and finalizes it.
+void loadCardRegistryFromFile(const std::string &filename, CardRegistry &registry);
+
+// Loads the card registry from a binary card image if it exists and is not
+// older than the text card file; otherwise parses the text card file.
+void loadCardRegistry(const std::string &textFile, const std::string &imageFile, CardRegistry &registry);
+// Parses an integer, ignoring surrounding whitespace and trailing non-digits.
+// Returns 0 if there is no number.
+int parseIntOrZero(std::string_view raw);
+
+// Reads a whole file into one buffer. Returns false if it cannot be read.
+bool readWholeFile(const std::string &filename, std::string &buffer);
+
+// Splits a file buffer into chunks of roughly `chunkBytes` that each start at a
+// `marker` line (BEGIN_POKEMON, BEGIN_DECK), so the chunks can be parsed in
+// parallel. Returns the start offset of every chunk followed by text.size().
+std::vector<size_t> splitIntoBlockChunks(std::string_view text, std::string_view marker, size_t chunkBytes);
 
 #endif // FILEPARSER_H
@@ -3,145 +3,21 @@
 #include "Constants.h"
 #include "Utils.h"
 #include "FileParser.h"
+#include "CardRegistry.h"
+#include "TranspositionTable.h"
+#include "SearchArena.h"
+#include "DrawOdds.h"
+#include "MoveGen.h"
 #include <iostream>
 #include <algorithm>
-#include <random>
 #include <limits>
 #include <omp.h>
 #include <fstream>
 #include <cctype>
-#include <sstream>
-#include <unordered_set>
-
-// Global variable to store all meta-decks at program startup.
-std::vector<std::string> allMetaDecks;
-
-// Loads all meta-decks from a file into the global `allMetaDecks` vector.
-// Parameters:
-// - filename: The file containing the meta-deck data.
-void loadAllMetaDecks(const std::string &filename) {
-    std::ifstream metaFile(filename);
-    if (!metaFile.is_open()) {
-        std::cerr << "Error: Could not open meta-decks file: " << filename << std::endl;
-        return;
-    }
-
-    std::string line;
-    std::string currentDeck;
-    while (std::getline(metaFile, line)) {
-        line = trim(line);
-        if (line == "BEGIN_DECK") {
-            currentDeck.clear();
-        } else if (line == "END_DECK") {
-            allMetaDecks.push_back(currentDeck);
-        } else {
-            currentDeck += line + "\n";
-        }
-    }
-    metaFile.close();
-}
-
-// Filters meta-decks based on visible Pokémon on the opponent's board.
-// Parameters:
-// - visiblePokemons: A vector of visible Pokémon names.
-// Returns:
-// - A vector of filtered meta-decks matching the visible Pokémon.
-std::vector<std::string> filterMetaDecksByVisibleBoard(
-    const std::vector<std::string> &visiblePokemons
-) {
-    std::vector<std::string> filteredDecks;
-
-    #pragma omp parallel
-    {
-        std::vector<std::string> localFilteredDecks; // Thread-local storage for matches.
-
-        #pragma omp for schedule(dynamic)
-        for (size_t i = 0; i < allMetaDecks.size(); ++i) {
-            const auto &deck = allMetaDecks[i];
-            std::istringstream deckStream(deck);
-            std::unordered_set<std::string> deckPokemons; // Fixed: Added std::unordered_set
-            std::string line;
-
-            // Parse Pokémon names in the deck.
-            while (std::getline(deckStream, line)) {
-                line = trim(line);
-                if (line.empty() || line == "BEGIN_DECK" || line == "END_DECK") continue;
-
-                auto tokens = splitAndTrim(line, ',');
-                if (tokens.size() == 2) {
-                    deckPokemons.insert(toLower(tokens[0]));
-                }
-            }
-
-            // Check if all visible Pokémon are in the deck.
-            bool allMatch = true;
-            for (const auto &visiblePoke : visiblePokemons) {
-                if (deckPokemons.find(toLower(visiblePoke)) == deckPokemons.end()) {
-                    allMatch = false;
-                    break;
-                }
-            }
-
-            if (allMatch) {
-                localFilteredDecks.push_back(deck);
-            }
-        }
-
-        // Merge thread-local results into the global vector.
-        #pragma omp critical
-        filteredDecks.insert(filteredDecks.end(), localFilteredDecks.begin(), localFilteredDecks.end());
-    }
-
-    if (filteredDecks.empty()) {
-        return allMetaDecks; // Return all meta-decks if no matches are found.
-    }
-
-    return filteredDecks;
-}
-
-// Updates the opponent's meta-deck guesses based on visible Pokémon.
-// Parameters:
-// - state: The current game state to update with meta-deck guesses.
-void updateMetaDeckGuesses(GameState &state) {
-    std::vector<std::string> visiblePokemons;
-
-    // Collect visible Pokémon names (active + bench).
-    visiblePokemons.push_back(state.opponentActivePokemon.name);
-    for (const auto &benchPoke : state.opponentBench) {
-        visiblePokemons.push_back(benchPoke.name);
-    }
-
-    // Filter meta-decks based on visible Pokémon.
-    state.oppMetaDeckGuesses = filterMetaDecksByVisibleBoard(visiblePokemons);
-}
-
-// Seeds the random number generator for parallel threads.
-void seedRNG() {
-    static bool seeded = false;
-    if (!seeded) {
-        #pragma omp parallel
-        {
-            thread_local std::random_device rd;
-            thread_local std::mt19937 gen(rd());
-        }
-        seeded = true;
-    }
-}
-
-// Evaluates the game state and returns a random value between 0.0 and 1.0.
-// This is a placeholder for a more complex evaluation function.
-// Parameters:
-// - state: The current game state to evaluate.
-// - depth: Optional parameter for evaluation depth (not used here).
-// Returns:
-// - A random double between 0.0 and 1.0.
-double evaluateGameState(const GameState &state, int /*depth*/) {
-    seedRNG(); // Ensure RNG is seeded once.
-    thread_local std::mt19937 gen;
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-
-    return dis(gen); // Return a random value between 0.0 and 1.0.
-}
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 // Processes user input for the current round and updates the game state.
 // Parameters:
@@ -154,43 +30,39 @@ void processRoundInput(GameState &state) {
 // Loads a preset deck from the deck file into the game state.
 void loadPresetDeck(
     const std::string &deckFile,
-    const std::unordered_map<std::string, Pokemon> &cardMap,
-    std::vector<Pokemon> &deck
+    const CardRegistry &registry,
+    std::vector<CardId> &deck
 ) {
-    std::ifstream file(deckFile);
-    if (!file.is_open()) {
+    std::string buffer;
+    if (!readWholeFile(deckFile, buffer)) {
         std::cerr << "Error: Cannot open deck file: " << deckFile << std::endl;
         return;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        line = trim(line);
+    std::string_view text(buffer);
+    std::string_view line;
+    while (nextLine(text, line)) {
+        line = trimView(line);
         if (line.empty()) continue;
 
-        auto tokens = splitAndTrim(line, ',');
-        if (tokens.size() < 2) {
+        std::string_view rest = line;
+        std::string_view cardName = nextToken(rest, ',');
+        if (rest.empty()) {
             std::cerr << "Warning: Deck entry malformed (need name, count): '"
                       << line << "'" << std::endl;
             continue;
         }
+        int count = parseIntOrZero(nextToken(rest, ','));
 
-        const std::string cardName = tokens[0];
-        int count = parseIntOrZero(tokens[1]);
-
-        auto it = cardMap.find(normalize(cardName));
-        if (it == cardMap.end()) {
+        CardId id = registry.find(cardName);
+        if (id == NO_CARD) {
             std::cerr << "Warning: Card '" << cardName
                       << "' not found in card database." << std::endl;
             continue;
         }
 
-        for (int i = 0; i < count; ++i) {
-            deck.push_back(it->second);
-        }
+        deck.insert(deck.end(), count, id);
     }
-
-    file.close();
 }
 
 // Simulates drawing the initial hand into the game state.
@@ -208,8 +80,7 @@ void drawInitialHand(GameState &state) {
     }
 
     for (const auto &cardName : cardNames) {
-        auto it = std::find_if(state.deck.begin(), state.deck.end(),
-                               [&cardName](const Pokemon &card) { return card.name == cardName; });
+        auto it = std::find(state.deck.begin(), state.deck.end(), state.cards->find(cardName));
         if (it != state.deck.end()) {
             state.hand.push_back(*it);
             state.deck.erase(it);
@@ -220,88 +91,480 @@ void drawInitialHand(GameState &state) {
     }
 }
 
-// Recursively simulates decision tree outcomes up to a specified depth.
+
+// Computes the distribution of the number of heads flipped for a skill:
+// binomial for a fixed number of flips, geometric capped at MAX_FLIP when
+// flipping until tails.
 // Parameters:
-// - state: The current game state.
-// - depth: The depth of the decision tree to simulate.
+// - flip: The skill's flip instruction, or nullptr if it does not flip.
+// - probabilities: Output, probability of 0..MAX_FLIP heads.
 // Returns:
-// - A double representing the average outcome of the decision tree simulation.
-double simulateDecisionTree(const GameState &state, int depth) {
-    if (depth == 0) {
-        return evaluateGameState(state);
+// - The number of entries written.
+static int headsDistribution(const EffectOp *flip, double *probabilities) {
+    if (flip == nullptr) {
+        probabilities[0] = 1.0;
+        return 1;
+    }
+    if (flip->opcode == OP_FLIP_UNTIL_TAILS) {
+        double p = 0.5;
+        for (int h = 0; h < MAX_FLIP; ++h, p *= 0.5) probabilities[h] = p;
+        probabilities[MAX_FLIP] = std::pow(0.5, MAX_FLIP);
+        return MAX_FLIP + 1;
     }
+    int n = std::min<int>(flip->count, MAX_FLIP);
+    double coefficient = 1.0;
+    double all = std::pow(0.5, n);
+    for (int h = 0; h <= n; ++h) {
+        probabilities[h] = coefficient * all;
+        coefficient = coefficient * (n - h) / (h + 1);
+    }
+    return n + 1;
+}
 
-    std::vector<GameState> nextStates;
+// Returns C(n, k).
+static constexpr int binomial(int n, int k) {
+    int result = 1;
+    for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+    return result;
+}
 
-    // Generate possible next states.
-    const Pokemon &attacker = state.activePokemon;
-    for (const auto &skill : attacker.skills) {
-        GameState s = state;
-        s.opponentActivePokemon.hp -= skill.dmg;
-        if (s.opponentActivePokemon.hp < 0)
-            s.opponentActivePokemon.hp = 0;
+static_assert(binomial(MAX_RANDOM_HITS + MAX_BENCH, MAX_BENCH) <= MAX_HIT_SPREADS,
+              "MAX_HIT_SPREADS must hold every spread of MAX_RANDOM_HITS hits over a full board");
 
-        nextStates.push_back(std::move(s));
+// Computes the distribution of random hits over the defender's Pokémon: one
+// entry per hit-count vector, each hit landing on a uniformly chosen slot.
+// Parameters:
+// - hits: The number of random hits, at most MAX_RANDOM_HITS.
+// - targets: The number of Pokémon in play that can be hit.
+// - spreads: Output, hit counts per slot (in AttackRolls::randomHits).
+// - probabilities: Output, probability of each spread.
+// Returns:
+// - The number of spreads written, C(hits + targets - 1, targets - 1).
+static int spreadRandomHits(int hits, int targets, AttackRolls *spreads, double *probabilities) {
+    int count = 1;
+    spreads[0] = AttackRolls();
+    probabilities[0] = 1.0;
+    for (int h = 0; h < hits; ++h) {
+        AttackRolls next[MAX_HIT_SPREADS];
+        double nextProbabilities[MAX_HIT_SPREADS];
+        int nextCount = 0;
+        for (int i = 0; i < count; ++i) {
+            for (int t = 0; t < targets; ++t) {
+                AttackRolls spread = spreads[i];
+                ++spread.randomHits[t];
+                double p = probabilities[i] / targets;
+                int j = 0;
+                while (j < nextCount && std::memcmp(next[j].randomHits, spread.randomHits, sizeof(spread.randomHits)) != 0) ++j;
+                if (j == nextCount) {
+                    next[nextCount] = spread;
+                    nextProbabilities[nextCount++] = p;
+                } else {
+                    nextProbabilities[j] += p;
+                }
+            }
+        }
+        std::copy(next, next + nextCount, spreads);
+        std::copy(nextProbabilities, nextProbabilities + nextCount, probabilities);
+        count = nextCount;
     }
+    return count;
+}
+
+// Returns the number of heads counts a flip instruction can produce.
+static int headsCounts(const EffectOp *flip) {
+    if (flip == nullptr) return 1;
+    if (flip->opcode == OP_FLIP_UNTIL_TAILS) return MAX_FLIP + 1;
+    return std::min<int>(flip->count, MAX_FLIP) + 1;
+}
 
-    if (nextStates.empty()) {
-        return evaluateGameState(state);
+// Returns the flip instruction of a skill, or nullptr.
+static const EffectOp *findFlip(const SkillData &skill) {
+    const EffectOp *flip = findEffect(skill, OP_FLIP_N);
+    return flip ? flip : findEffect(skill, OP_FLIP_UNTIL_TAILS);
+}
+
+// Bounds the chance outcomes of the player using a skill.
+int chanceOutcomeBound(const SearchState &state, const SkillData &skill) {
+    const SideState &def = state.sides[1];
+    const EffectOp *randomHits = findEffect(skill, OP_RANDOM_HITS);
+    int spreads = randomHits ? binomial(std::min<int>(randomHits->count, MAX_RANDOM_HITS) + def.benchCount, def.benchCount) : 1;
+    int switchCount = (findEffect(skill, OP_SWITCH_OUT) && def.benchCount > 0) ? def.benchCount : 1;
+    return headsCounts(findFlip(skill)) * spreads * switchCount;
+}
+
+// Enumerates the chance outcomes of the player using a skill.
+int expandChanceOutcomes(const SearchState &state, const CardTable &table,
+                         const SkillData &skill, ChanceOutcome *outcomes) {
+    const SideState &def = state.sides[1];
+
+    double headsProbabilities[MAX_FLIP + 1];
+    int headsCount = headsDistribution(findFlip(skill), headsProbabilities);
+
+    const EffectOp *randomHits = findEffect(skill, OP_RANDOM_HITS);
+    AttackRolls spreads[MAX_HIT_SPREADS];
+    double spreadProbabilities[MAX_HIT_SPREADS];
+    int spreadCount = spreadRandomHits(randomHits ? std::min<int>(randomHits->count, MAX_RANDOM_HITS) : 0,
+                                       def.benchCount + 1, spreads, spreadProbabilities);
+
+    int switchCount = (findEffect(skill, OP_SWITCH_OUT) && def.benchCount > 0) ? def.benchCount : 1;
+
+    // Outcomes are merged when their states are equal; the hash only skips
+    // the comparison of states that differ.
+    uint64_t hashes[MAX_CHANCE_OUTCOMES];
+    int count = 0;
+    for (int h = 0; h < headsCount; ++h) {
+        for (int r = 0; r < spreadCount; ++r) {
+            for (int w = 0; w < switchCount; ++w) {
+                double p = headsProbabilities[h] * spreadProbabilities[r] / switchCount;
+                if (p <= 0.0) continue;
+
+                AttackRolls rolls = spreads[r];
+                rolls.heads = h;
+                rolls.switchSlot = w;
+
+                SearchState child = state;
+                resolveAttack(table, child.sides[0], child.sides[1], skill, rolls);
+                uint64_t key = zobristHash(child);
+
+                int j = 0;
+                while (j < count &&
+                       (hashes[j] != key || std::memcmp(&outcomes[j].state, &child, sizeof(child)) != 0)) ++j;
+                if (j == count) {
+                    hashes[count] = key;
+                    outcomes[count++] = ChanceOutcome{child, p};
+                } else {
+                    outcomes[j].probability += p;
+                }
+            }
+        }
     }
+    return count;
+}
 
-    double totalOutcome = 0.0;
+// Time limit of a running search. Searches without a budget pass nullptr.
+struct SearchControl {
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool> stopped{false};
+};
+
+// Returns true once the search has run out of time. The clock is read every
+// 256 calls per thread; the first thread past the deadline stops all others.
+static bool searchStopped(SearchControl *control) {
+    if (control == nullptr) return false;
+    if (control->stopped.load(std::memory_order_relaxed)) return true;
+    thread_local unsigned calls = 0;
+    if ((++calls & 255) == 0 && std::chrono::steady_clock::now() >= control->deadline) {
+        control->stopped.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
 
-    // Parallelize only the top level of recursion.
-    #pragma omp parallel for reduction(+:totalOutcome) schedule(dynamic)
-    for (size_t i = 0; i < nextStates.size(); ++i) {
-        totalOutcome += simulateDecisionTreeSequential(nextStates[i], depth - 1);
+// Backs up the value of a searched state: the best skill for the player.
+// Results are shared with other threads through the transposition table;
+// values of a stopped search are incomplete and are not stored.
+// Parameters:
+// - key: Zobrist hash of the state.
+// - values: Expected values of the skills, in the order of `skills`.
+// - skills: Indices of the skills searched.
+// - numMoves: Number of skills.
+// - depth: Remaining depth of the state.
+// - control: Time limit of the search, or nullptr.
+// Returns:
+// - The value of the best skill, or 0 (a loss) if there are no skills.
+static double backUpValue(uint64_t key, const double *values, const int *skills, int numMoves, int depth,
+                          SearchControl *control) {
+    if (numMoves <= 0) return 0.0;
+    int best = 0;
+    for (int i = 1; i < numMoves; ++i) {
+        if (values[i] > values[best]) best = i;
     }
+    if (!searchStopped(control)) transpositionTable.store(key, TTEntry{values[best], depth, skills[best]});
+    return values[best];
+}
 
-    return totalOutcome / nextStates.size();
+// Lists the skills the player's Active Pokémon can use, with the move
+// generator's rule for attacks: the energy cost is paid, the Pokémon is not
+// paralyzed and the opponent has an Active Pokémon.
+// Returns:
+// - The number of skill indices written to `skills`.
+static int legalSkills(const SearchState &state, const CardTable &table, int *skills) {
+    const SideState &me = state.sides[0];
+    if (me.active.card == NO_CARD) return 0;
+    int count = 0;
+    for (int i = 0; i < table[me.active.card].skillCount; ++i) {
+        if (isLegalMove(table, me, state.sides[1], Move{MOVE_ATTACK, static_cast<uint8_t>(i), 0})) skills[count++] = i;
+    }
+    return count;
 }
 
-// Helper function to run the decision tree sequentially.
+// Returns the value of a state that needs no search: the result of a
+// finished game, or the evaluation at the depth limit or when the player has
+// no legal attack. Returns -1 otherwise.
 // Parameters:
-// - state: The current game state.
-// - depth: The depth of the decision tree to simulate.
+// - skills: Output, the legal skills of a state that needs a search.
+// - numSkills: Output, the number of legal skills.
+static double leafValue(const SearchState &state, const CardTable &table, int depth, int *skills, int &numSkills) {
+    numSkills = 0;
+    double outcome = gameOutcome(state);
+    if (outcome >= 0.0) return outcome;
+    if (depth == 0) return evaluateSearchState(state, table);
+    numSkills = legalSkills(state, table, skills);
+    if (numSkills == 0) return evaluateSearchState(state, table);
+    return -1.0;
+}
+
+// Runs the decision tree sequentially over the compact search state.
+static double searchSequential(const SearchState &state, const CardTable &table, int depth, SearchControl *control) {
+    if (searchStopped(control)) return 0.0;
+    countStat(COUNTER_NODES);
+    int skills[MAX_SKILLS];
+    int numSkills;
+    double leaf = leafValue(state, table, depth, skills, numSkills);
+    if (leaf >= 0.0) return leaf;
+
+    uint64_t key = zobristHash(state);
+    TTEntry entry;
+    if (transpositionTable.probe(key, entry) && entry.depth >= depth) {
+        return entry.value;
+    }
+
+    // Outcomes live in the thread's arena rather than on the stack, which
+    // would otherwise hold MAX_CHANCE_OUTCOMES states per ply.
+    const CardData &card = table[state.sides[0].active.card];
+    int maxOutcomes = 1;
+    for (int i = 0; i < numSkills; ++i) maxOutcomes = std::max(maxOutcomes, chanceOutcomeBound(state, card.skills[skills[i]]));
+    ArenaScope scope;
+    ChanceOutcome *outcomes = scope.arena().allocate<ChanceOutcome>(maxOutcomes);
+    double values[MAX_SKILLS];
+    for (int i = 0; i < numSkills; ++i) {
+        int numOutcomes = expandChanceOutcomes(state, table, card.skills[skills[i]], outcomes);
+        values[i] = 0.0;
+        for (int j = 0; j < numOutcomes; ++j) {
+            values[i] += outcomes[j].probability * searchSequential(outcomes[j].state, table, depth - 1, control);
+        }
+    }
+
+    return backUpValue(key, values, skills, numSkills, depth, control);
+}
+
+static double searchTasks(const SearchState &state, const CardTable &table, int depth, SearchControl *control);
+
+// Computes the expected value of the player using one skill, searching each
+// chance outcome as an OpenMP task. Must be called from inside a parallel region.
+// Parameters:
+// - state: The state the skill is used in.
+// - table: The card table the state refers to.
+// - skill: The skill used by the player's Active Pokémon.
+// - depth: The remaining depth of the state.
+// - control: Time limit of the search, or nullptr.
 // Returns:
-// - A double representing the average outcome of the sequential simulation.
-double simulateDecisionTreeSequential(const GameState &state, int depth) {
-    if (depth == 0) {
-        return evaluateGameState(state);
+// - The expected value over the skill's outcomes.
+static double searchSkillTasks(const SearchState &state, const CardTable &table, const SkillData &skill,
+                               int depth, SearchControl *control) {
+    // Outcomes and results live in this thread's arena until the taskwait;
+    // the tasks that read them may run on other threads.
+    ArenaScope scope;
+    ChanceOutcome *outcomes = scope.arena().allocate<ChanceOutcome>(chanceOutcomeBound(state, skill));
+    int numOutcomes = expandChanceOutcomes(state, table, skill, outcomes);
+    double *results = scope.arena().allocate<double>(numOutcomes);
+
+    // The current thread searches the last outcome itself while the others
+    // are left for idle threads.
+    for (int j = 0; j < numOutcomes - 1; ++j) {
+        const SearchState *child = &outcomes[j].state;
+        double *result = &results[j];
+        #pragma omp task default(none) firstprivate(child, result, depth, control) shared(table)
+        *result = searchTasks(*child, table, depth - 1, control);
     }
+    results[numOutcomes - 1] = searchTasks(outcomes[numOutcomes - 1].state, table, depth - 1, control);
+    #pragma omp taskwait
 
-    std::vector<GameState> nextStates;
+    double value = 0.0;
+    for (int j = 0; j < numOutcomes; ++j) value += outcomes[j].probability * results[j];
+    return value;
+}
 
-    // Generate possible next states.
-    const Pokemon &attacker = state.activePokemon;
-    for (const auto &skill : attacker.skills) {
-        GameState s = state;
-        s.opponentActivePokemon.hp -= skill.dmg;
-        if (s.opponentActivePokemon.hp < 0)
-            s.opponentActivePokemon.hp = 0;
+// Searches a state in parallel. Each skill and each of its chance outcomes
+// becomes an OpenMP task, so idle threads steal work at every level of the
+// tree; subtrees with less than MIN_TASK_DEPTH plies left run sequentially to
+// keep task overhead small. Must be called from inside a parallel region.
+// Parameters:
+// - state: The state to search.
+// - table: The card table the state refers to.
+// - depth: The remaining depth.
+// - control: Time limit of the search, or nullptr.
+// Returns:
+// - The value of the best line found.
+static double searchTasks(const SearchState &state, const CardTable &table, int depth, SearchControl *control) {
+    if (depth < MIN_TASK_DEPTH) {
+        BusyTimer busy;
+        return searchSequential(state, table, depth, control);
+    }
+    if (searchStopped(control)) return 0.0;
+    countStat(COUNTER_NODES);
+    int skills[MAX_SKILLS];
+    int numSkills;
+    double leaf = leafValue(state, table, depth, skills, numSkills);
+    if (leaf >= 0.0) return leaf;
+
+    uint64_t key = zobristHash(state);
+    TTEntry entry;
+    if (transpositionTable.probe(key, entry) && entry.depth >= depth) {
+        return entry.value;
+    }
 
-        nextStates.push_back(std::move(s));
+    const CardData &card = table[state.sides[0].active.card];
+    double values[MAX_SKILLS];
+    for (int i = 0; i < numSkills - 1; ++i) {
+        const SkillData *skill = &card.skills[skills[i]];
+        #pragma omp task default(none) firstprivate(i, skill, depth, control) shared(state, table, values)
+        values[i] = searchSkillTasks(state, table, *skill, depth, control);
     }
+    int last = numSkills - 1;
+    values[last] = searchSkillTasks(state, table, card.skills[skills[last]], depth, control);
+    #pragma omp taskwait
 
-    if (nextStates.empty()) {
-        return evaluateGameState(state);
+    return backUpValue(key, values, skills, numSkills, depth, control);
+}
+
+// Recursively simulates decision tree outcomes up to a specified depth.
+// Parameters:
+// - state: The current game state.
+// - depth: The depth of the decision tree to simulate.
+// - stats: Output, statistics of the search, or nullptr.
+// Returns:
+// - A double representing the value of the best line found.
+double simulateDecisionTree(const GameState &state, int depth, SearchStats *stats) {
+    const CardTable &table = state.cards->table();
+    const SearchState root = toSearchState(state);
+    double value = 0.0;
+    SearchStats before;
+    if (stats) before = statsSnapshot();
+
+    {
+        PhaseTimer timer(PHASE_SEARCH);
+        // One thread walks the tree and spawns tasks; the rest of the team
+        // executes them.
+        #pragma omp parallel
+        {
+            searchArena().reset();
+            #pragma omp single
+            value = searchTasks(root, table, depth, nullptr);
+        }
     }
 
-    double totalOutcome = 0.0;
+    if (stats) *stats = statsDifference(statsSnapshot(), before);
+    return value;
+}
 
-    for (const auto &nextState : nextStates) {
-        totalOutcome += simulateDecisionTreeSequential(nextState, depth - 1);
+// Searches with iterative deepening until the time budget runs out.
+// Parameters:
+// - state: The current game state.
+// - budgetMs: The time budget in milliseconds.
+// - maxDepth: The deepest iteration to run.
+// Returns:
+// - The best move and value of the deepest iteration that searched it.
+static SearchResult searchWithBudget(const GameState &state, int budgetMs, int maxDepth) {
+    const CardTable &table = state.cards->table();
+    const SearchState root = toSearchState(state);
+    SearchResult result;
+
+    int order[MAX_SKILLS];
+    int numSkills;
+    double leaf = leafValue(root, table, 1, order, numSkills);
+    if (leaf >= 0.0) {
+        result.value = leaf;
+        return result;
     }
 
-    return totalOutcome / nextStates.size();
+    SearchControl control;
+    control.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+
+    // Root moves (the legal skills) in the order of the previous iteration's
+    // values.
+    result.attacker = root.sides[0].active.card;
+    const CardData &card = table[result.attacker];
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        double values[MAX_SKILLS];
+        int completed = 0;
+
+        // The root moves run one after another, best first, so that a stopped
+        // iteration has still searched the most promising ones. Each move's
+        // subtree is split into tasks. Every thread starts the iteration with
+        // an empty node arena.
+        #pragma omp parallel
+        {
+            searchArena().reset();
+            #pragma omp single
+            for (; completed < numSkills; ++completed) {
+                int move = order[completed];
+                values[move] = searchSkillTasks(root, table, card.skills[move], depth, &control);
+                if (control.stopped.load(std::memory_order_relaxed)) break;
+            }
+        }
+        if (completed == 0) break;
+
+        // Moves of the same iteration are compared only with each other.
+        int best = order[0];
+        for (int k = 1; k < completed; ++k) {
+            if (values[order[k]] > values[best]) best = order[k];
+        }
+        result.value = values[best];
+        result.bestMove = best;
+        if (completed < numSkills) break;
+
+        result.depth = depth;
+        transpositionTable.store(zobristHash(root), TTEntry{values[best], depth, best});
+        std::stable_sort(order, order + numSkills, [&](int x, int y) { return values[x] > values[y]; });
+        if (std::chrono::steady_clock::now() >= control.deadline) break;
+    }
+    return result;
+}
+
+// Searches with iterative deepening and reports the statistics of the search.
+SearchResult simulateDecisionTreeWithBudget(const GameState &state, int budgetMs, int maxDepth) {
+    SearchStats before = statsSnapshot();
+    SearchResult result;
+    {
+        PhaseTimer timer(PHASE_SEARCH);
+        result = searchWithBudget(state, budgetMs, maxDepth);
+    }
+    result.stats = statsDifference(statsSnapshot(), before);
+    return result;
+}
+
+// Helper function to run the decision tree sequentially.
+// Parameters:
+// - state: The current game state.
+// - depth: The depth of the decision tree to simulate.
+// Returns:
+// - A double representing the value of the best line found.
+double simulateDecisionTreeSequential(const GameState &state, int depth) {
+    return simulateDecisionTreeSequential(toSearchState(state), state.cards->table(), depth);
+}
+
+// Runs the decision tree sequentially over the compact search state.
+// Parameters:
+// - state: The current search state.
+// - table: The card table the state refers to.
+// - depth: The depth of the decision tree to simulate.
+// Returns:
+// - A double representing the value of the best line found.
+double simulateDecisionTreeSequential(const SearchState &state, const CardTable &table, int depth) {
+    PhaseTimer timer(PHASE_SEARCH);
+    BusyTimer busy;
+    return searchSequential(state, table, depth, nullptr);
 }
 
 // Pre-Start: Displays the current deck composition.
 void preStartConfiguration(const GameState &state) {
     std::cout << "Pre-Start: Current Deck Composition:" << std::endl;
-    for (const auto &card : state.deck) {
-        std::cout << "  " << card.name << std::endl;
+    for (CardId id : state.deck) {
+        std::cout << "  " << state.cards->name(id) << std::endl;
     }
+    printDrawOdds(std::cout, *state.cards, state.deck, DRAW_ODDS_TURNS);
 }
 
 // Pre-1st Round: Collects coin flip result and opponent's main energy type.
@@ -310,7 +573,8 @@ void preFirstRoundConfiguration(GameState &state) {
     std::cout << "\nPre-1st Round Configuration:" << std::endl;
     std::cout << "Enter coin flip result (H for Heads, T for Tails): ";
     std::cin >> coinResult;
-    if (toLower(coinResult) == "h") {
+    state.goingFirst = (toLower(coinResult) == "h");
+    if (state.goingFirst) {
         std::cout << "You will go first." << std::endl;
     } else {
         std::cout << "You will go second." << std::endl;
@@ -320,11 +584,12 @@ void preFirstRoundConfiguration(GameState &state) {
     std::string opponentEnergy;
     std::cout << "Enter opponent's main energy type: ";
     std::getline(std::cin, opponentEnergy);
+    state.opponentEnergyType = trim(opponentEnergy);
     std::cout << "Opponent's main energy type: " << opponentEnergy << std::endl;
 }
 
 // Post-1st Round: Collects board state updates and attack action data.
-void postFirstRoundUpdate(GameState &state, const std::unordered_map<std::string, Pokemon> &cardMap) {
+void postFirstRoundUpdate(GameState &state, const CardRegistry &registry) {
     std::cout << "\nPost-1st Round Update:\n";
     // ...existing code for updating the board state...
 }
@@ -337,7 +602,12 @@ void preEveryRoundConfiguration(GameState &state) {
     std::getline(std::cin, drawnCard);
 
     if (!drawnCard.empty() && toLower(drawnCard) != "none") {
-        state.hand.push_back(Pokemon(drawnCard));
+        CardId id = state.cards->find(drawnCard);
+        if (id == NO_CARD) {
+            std::cerr << "Warning: Card '" << drawnCard << "' not found in card database." << std::endl;
+        } else {
+            state.hand.push_back(id);
+        }
     }
 }
 
@@ -345,4 +615,20 @@ void preEveryRoundConfiguration(GameState &state) {
 void postEveryRoundUpdate(GameState &state) {
     std::cout << "\nPost-Every Round Update:\n";
     // ...existing code for processing actions and updating the state...
+
+    state.attacksThisRound.clear();
+    std::cout << "Enter the opponent's attacking Pokémon (or none): ";
+    std::string attacker;
+    std::getline(std::cin, attacker);
+    attacker = trim(attacker);
+    if (attacker.empty() || toLower(attacker) == "none") return;
+
+    if (state.cards->find(attacker) == NO_CARD) {
+        std::cerr << "Warning: Card '" << attacker << "' not found in card database." << std::endl;
+        return;
+    }
+    std::string target(state.activePokemon.id != NO_CARD ? state.cards->name(state.activePokemon.id) : "");
+    AttackRecord attack{attacker, "", target, {}};
+    state.attacksThisRound.push_back(attack);
+    state.oppAttacks.push_back(attack);
 }
@@ -3,25 +3,14 @@
 #define GAMESIMULATION_H
 
 #include "PokemonCard.h" // Includes GameState and related structures.
-#include <unordered_map>
+#include "MonteCarlo.h"  // Declares monteCarloSimulation.
+#include "SearchState.h" // Compact state used by the decision tree.
+#include "Evaluation.h"  // Declares the static evaluation.
+#include "CardRegistry.h"
+#include "TranspositionTable.h"
+#include "EngineStats.h"
 #include <string>
 
-// Evaluates the game state and returns a value between 0.0 and 1.0.
-// This function is used to assess the current state of the game.
-// Parameters:
-// - state: The current game state to evaluate.
-// - depth: Optional parameter to specify the depth of evaluation (default is 0).
-double evaluateGameState(const GameState &state, int depth = 0);
-
-// Runs a Monte Carlo simulation over the game state.
-// Simulates multiple random outcomes to estimate probabilities.
-// Parameters:
-// - state: The current game state.
-// - numSimulations: The number of simulations to run.
-// Returns:
-// - A double representing the average outcome of the simulations.
-double monteCarloSimulation(const GameState &state, int numSimulations);
-
 // Processes input for the current round and updates the game state.
 // Handles user interactions for actions like attacking, retreating, or using items.
 // Parameters:
@@ -32,11 +21,11 @@ void processRoundInput(GameState &state);
 // Validates the deck against the card database.
 // Parameters:
 // - deckFile: The file containing the deck information.
-// - cardMap: A map of card names to their corresponding Pokémon objects.
-// - deck: The vector to populate with the loaded deck.
+// - registry: The card registry to resolve card names against.
+// - deck: The vector to populate with the IDs of the loaded cards.
 void loadPresetDeck(const std::string &deckFile,
-                    const std::unordered_map<std::string, Pokemon> &cardMap,
-                    std::vector<Pokemon> &deck);
+                    const CardRegistry &registry,
+                    std::vector<CardId> &deck);
 
 // Simulates drawing the initial hand into the game state.
 // Ensures the player starts with a valid hand.
@@ -45,13 +34,70 @@ void loadPresetDeck(const std::string &deckFile,
 void drawInitialHand(GameState &state);
 
 // Recursively simulates decision tree outcomes up to a specified depth.
-// Used to evaluate the best possible moves.
+// Used to evaluate the best possible moves. Each state is worth its best
+// child; searched states and their best move are kept in the shared
+// transposition table, so positions reached by different move orders are
+// searched once.
+// Subtrees are searched as OpenMP tasks at every level down to
+// MIN_TASK_DEPTH, so all threads stay busy even with one or two moves per ply.
 // Parameters:
 // - state: The current game state.
 // - depth: The depth of the decision tree to simulate.
+// - stats: Output, the engine statistics collected during the search, or nullptr.
+// Returns:
+// - A double representing the value of the best line found.
+double simulateDecisionTree(const GameState &state, int depth, SearchStats *stats = nullptr);
+
+// Result of a search with a time budget.
+struct SearchResult {
+    double value = 0.0;             // Value of the best move found.
+    int bestMove = NO_MOVE;         // Index of the best skill, NO_MOVE if there is no move.
+    CardId attacker = NO_CARD;      // Active Pokémon that uses the best skill.
+    int depth = 0;                  // Deepest iteration that completed.
+    SearchStats stats;              // Engine statistics collected during the search.
+};
+
+// Searches the decision tree with iterative deepening until a time budget
+// runs out. Each iteration searches the root moves in the order of the
+// previous iteration's values; deeper nodes reuse the transposition table
+// filled by earlier iterations. When the budget expires mid-iteration, the
+// moves that iteration finished are compared with each other, and the
+// previous iteration's answer is kept if none finished.
+// Parameters:
+// - state: The current game state.
+// - budgetMs: The time budget in milliseconds.
+// - maxDepth: The deepest iteration to run.
 // Returns:
-// - A double representing the average outcome of the decision tree simulation.
-double simulateDecisionTree(const GameState &state, int depth);
+// - The best move, its value and the depth searched.
+SearchResult simulateDecisionTreeWithBudget(const GameState &state, int budgetMs, int maxDepth = MAX_SEARCH_DEPTH);
+
+// One outcome of a chance node: the resulting state and its probability.
+struct ChanceOutcome {
+    SearchState state;
+    double probability;
+};
+
+// Returns an upper bound on the chance outcomes of the player using a skill:
+// heads counts times random hit spreads times switch targets. Never more than
+// MAX_CHANCE_OUTCOMES.
+// Parameters:
+// - state: The state the skill is used in.
+// - skill: The skill used by the player's Active Pokémon.
+int chanceOutcomeBound(const SearchState &state, const SkillData &skill);
+
+// Enumerates the chance outcomes of the player using a skill: expands one
+// search node. Coin flips, random hits and switch targets are expanded
+// analytically; rolls that lead to the same state are merged into one outcome.
+// Parameters:
+// - state: The state the skill is used in.
+// - table: The card table the state refers to.
+// - skill: The skill used by the player's Active Pokémon.
+// - outcomes: Output buffer with room for chanceOutcomeBound(state, skill)
+//   outcomes.
+// Returns:
+// - The number of outcomes written.
+int expandChanceOutcomes(const SearchState &state, const CardTable &table,
+                         const SkillData &skill, ChanceOutcome *outcomes);
 
 // Helper function to run the decision tree sequentially.
 // Used internally for recursive simulations.
@@ -59,12 +105,22 @@ double simulateDecisionTree(const GameState &state, int depth);
 // - state: The current game state.
 // - depth: The depth of the decision tree to simulate.
 // Returns:
-// - A double representing the average outcome of the sequential simulation.
+// - A double representing the value of the best line found.
 double simulateDecisionTreeSequential(const GameState &state, int depth);
 
+// Runs the decision tree sequentially over the compact search state.
+// Children are expanded into a fixed-size buffer by copying the parent state.
+// Parameters:
+// - state: The current search state.
+// - table: The card table the state refers to.
+// - depth: The depth of the decision tree to simulate.
+// Returns:
+// - A double representing the value of the best line found.
+double simulateDecisionTreeSequential(const SearchState &state, const CardTable &table, int depth);
+
 // ----- Gameplay Phase Functions -----
 
-// Pre-Start: Displays the current deck composition.
+// Pre-Start: Displays the current deck composition and its draw odds.
 // Parameters:
 // - state: The current game state containing the deck to display.
 void preStartConfiguration(const GameState &state);
@@ -77,8 +133,8 @@ void preFirstRoundConfiguration(GameState &state);
 // Post-1st Round: Collects board state updates and attack action data.
 // Parameters:
 // - state: The current game state to update.
-// - cardMap: A map of card names to their corresponding Pokémon objects.
-void postFirstRoundUpdate(GameState &state, const std::unordered_map<std::string, Pokemon> &cardMap);
+// - registry: The card registry to resolve card names against.
+void postFirstRoundUpdate(GameState &state, const CardRegistry &registry);
 
 // Pre-Every Round: Prompts for new card draw input.
 // Parameters:
@@ -0,0 +1,210 @@
+// Knockouts.cpp
+#include "Knockouts.h"
+#include <bit>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KNOCKOUT_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Returns the best instruction set this CPU supports.
+KernelIsa detectKernelIsa() {
+#ifdef KNOCKOUT_AVX2
+    static const KernelIsa isa = __builtin_cpu_supports("avx2") ? KERNEL_AVX2 : KERNEL_SCALAR;
+    return isa;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+// Returns true if `damage` knocks out a defender with `hp` HP left. Typeless
+// attackers never hit weakness.
+static inline bool isKnockout(int32_t damage, int32_t attackerType, int32_t hp, int32_t weakness,
+                              int32_t reduction) {
+    int32_t bonus = (attackerType >= 0 && weakness == attackerType) ? WEAKNESS_BONUS : 0;
+    return damage > 0 && hp <= damage + bonus - reduction;
+}
+
+// Answers lanes `from` to `count` one at a time.
+static uint64_t knockoutMaskScalar(const KnockoutLanes &lanes, int from) {
+    uint64_t mask = 0;
+    for (int i = from; i < lanes.count; ++i) {
+        if (isKnockout(lanes.damage[i], lanes.attackerType[i], lanes.hp[i], lanes.weakness[i], lanes.reduction[i])) {
+            mask |= 1ULL << i;
+        }
+    }
+    return mask;
+}
+
+// Scans cards `from` to the end of the pool one at a time.
+static void knockoutCardsScalar(const CardColumns &columns, int32_t damage, int32_t attackerType,
+                                size_t from, std::vector<uint64_t> &mask) {
+    for (size_t i = from; i < columns.size(); ++i) {
+        if (isKnockout(damage, attackerType, columns.hp[i], columns.weakness[i], 0)) mask[i / 64] |= 1ULL << (i % 64);
+    }
+}
+
+#ifdef KNOCKOUT_AVX2
+// Answers eight lanes per step: weakness is a compare and a mask, the
+// knockout test a second compare, and movemask packs the lanes into bits.
+__attribute__((target("avx2")))
+static inline uint32_t knockoutBits8(__m256i damage, __m256i attackerType, __m256i hp, __m256i weakness,
+                                     __m256i reduction) {
+    const __m256i none = _mm256_set1_epi32(-1);
+    const __m256i weak = _mm256_and_si256(_mm256_cmpeq_epi32(weakness, attackerType),
+                                          _mm256_cmpgt_epi32(attackerType, none));
+    __m256i dealt = _mm256_add_epi32(damage, _mm256_and_si256(weak, _mm256_set1_epi32(WEAKNESS_BONUS)));
+    dealt = _mm256_sub_epi32(dealt, reduction);
+    __m256i knockout = _mm256_andnot_si256(_mm256_cmpgt_epi32(hp, dealt),
+                                           _mm256_cmpgt_epi32(damage, _mm256_setzero_si256()));
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(knockout)));
+}
+
+__attribute__((target("avx2")))
+static uint64_t knockoutMaskAvx2(const KnockoutLanes &lanes) {
+    uint64_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= lanes.count; i += 8) {
+        uint32_t bits = knockoutBits8(_mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.damage + i)),
+                                      _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.attackerType + i)),
+                                      _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.hp + i)),
+                                      _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.weakness + i)),
+                                      _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.reduction + i)));
+        mask |= static_cast<uint64_t>(bits) << i;
+    }
+    return mask | knockoutMaskScalar(lanes, i);
+}
+
+__attribute__((target("avx2")))
+static void knockoutCardsAvx2(const CardColumns &columns, int32_t damage, int32_t attackerType,
+                              std::vector<uint64_t> &mask) {
+    const __m256i damage8 = _mm256_set1_epi32(damage);
+    const __m256i type8 = _mm256_set1_epi32(attackerType);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= columns.size(); i += 8) {
+        uint32_t bits = knockoutBits8(damage8, type8,
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.hp.data() + i)),
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.weakness.data() + i)),
+                                      zero);
+        mask[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+    }
+    knockoutCardsScalar(columns, damage, attackerType, i, mask);
+}
+#endif
+
+// Answers every lane at once.
+uint64_t knockoutMask(const KnockoutLanes &lanes, KernelIsa isa) {
+#ifdef KNOCKOUT_AVX2
+    if (isa == KERNEL_AVX2) return knockoutMaskAvx2(lanes);
+#endif
+    (void)isa;
+    return knockoutMaskScalar(lanes, 0);
+}
+
+// Scans the card pool for the Pokémon an attack knocks out from full HP.
+void knockoutCards(const CardTable &table, int damage, int attackerType, std::vector<uint64_t> &mask,
+                   KernelIsa isa) {
+    const CardColumns &columns = table.columns();
+    mask.assign((columns.size() + 63) / 64, 0);
+#ifdef KNOCKOUT_AVX2
+    if (isa == KERNEL_AVX2) {
+        knockoutCardsAvx2(columns, damage, attackerType, mask);
+        return;
+    }
+#endif
+    (void)isa;
+    knockoutCardsScalar(columns, damage, attackerType, 0, mask);
+}
+
+// Returns true if any skill knocks out any opposing Pokémon.
+bool KnockoutMatrix::any() const {
+    for (const auto &slot : targets) {
+        for (uint8_t skill : slot) {
+            if (skill != 0) return true;
+        }
+    }
+    return false;
+}
+
+// Returns the damage a skill's hit gains against a defender from bonuses that
+// apply whatever the coins show.
+static int32_t defenderBonus(const SkillData &skill, const SlotState &defender) {
+    int32_t bonus = 0;
+    int32_t pending = 0;
+    for (int i = 0; i < skill.opCount; ++i) {
+        const EffectOp &op = skill.ops[i];
+        switch (op.opcode) {
+        case OP_DMG_IF_POISONED: if (defender.status & STATUS_POISONED) pending += op.value; break;
+        case OP_DMG_IF_PARALYZED: if (defender.status & STATUS_PARALYZED) pending += op.value; break;
+        case OP_DMG_PER_ENERGY: pending += op.value * totalEnergy(defender); break;
+        case OP_HIT: bonus += pending; pending = 0; break;
+        default: break;
+        }
+    }
+    return bonus;
+}
+
+// Returns the board slot with the given number.
+static inline const SlotState &slotAt(const SideState &side, int slot) {
+    return slot == 0 ? side.active : side.bench[slot - 1];
+}
+
+// Fills the knockout matrix of `me` against `opp`.
+void findKnockouts(const CardTable &table, const SideState &me, const SideState &opp, KnockoutMatrix &knockouts,
+                   KernelIsa isa) {
+    static_assert((MAX_BENCH + 1) * MAX_SKILLS * (MAX_BENCH + 1) <= KnockoutLanes::CAPACITY,
+                  "Every attacker, skill and defender must fit in one set of lanes.");
+    knockouts = KnockoutMatrix();
+    const CardColumns &columns = table.columns();
+    KnockoutLanes lanes;
+    uint8_t laneAttacker[KnockoutLanes::CAPACITY];
+    uint8_t laneSkill[KnockoutLanes::CAPACITY];
+    uint8_t laneDefender[KnockoutLanes::CAPACITY];
+
+    for (int a = 0; a <= me.benchCount; ++a) {
+        const SlotState &attacker = slotAt(me, a);
+        if (attacker.card == NO_CARD || (attacker.status & STATUS_PARALYZED)) continue;
+        const CardData &card = table[attacker.card];
+        for (int s = 0; s < card.skillCount; ++s) {
+            int32_t damage = columns.skillDamage[s][attacker.card];
+            if (damage <= 0 || !canAfford(attacker, card.skills[s])) continue;
+            for (int d = 0; d <= opp.benchCount; ++d) {
+                const SlotState &defender = slotAt(opp, d);
+                if (defender.card == NO_CARD || defender.hp <= 0) continue;
+                int k = lanes.count++;
+                lanes.damage[k] = damage + defenderBonus(card.skills[s], defender);
+                lanes.attackerType[k] = columns.type[attacker.card];
+                lanes.hp[k] = defender.hp;
+                lanes.weakness[k] = columns.weakness[defender.card];
+                lanes.reduction[k] = defender.damageReduction;
+                laneAttacker[k] = static_cast<uint8_t>(a);
+                laneSkill[k] = static_cast<uint8_t>(s);
+                laneDefender[k] = static_cast<uint8_t>(d);
+            }
+        }
+    }
+
+    uint64_t mask = knockoutMask(lanes, isa);
+    for (; mask != 0; mask &= mask - 1) {
+        int k = std::countr_zero(mask);
+        knockouts.targets[laneAttacker[k]][laneSkill[k]] |= static_cast<uint8_t>(1u << laneDefender[k]);
+    }
+}
+
+// Prints the knockouts available to the player this turn.
+void printKnockouts(std::ostream &out, const CardRegistry &registry, const SideState &me, const SideState &opp) {
+    KnockoutMatrix knockouts;
+    findKnockouts(registry.table(), me, opp, knockouts);
+    for (int a = 0; a <= me.benchCount; ++a) {
+        const SlotState &attacker = slotAt(me, a);
+        for (int s = 0; s < MAX_SKILLS; ++s) {
+            // Attacks hit the opposing Active; benched Pokémon need a switch first.
+            if (knockouts.targets[a][s] & 1) {
+                out << "Knockout: " << registry.name(attacker.card) << "'s " << registry.skillName(attacker.card, s)
+                    << " knocks out " << registry.name(opp.active.card) << (a == 0 ? "" : " after a switch")
+                    << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// Knockouts.h
+#ifndef KNOCKOUTS_H
+#define KNOCKOUTS_H
+
+#include "SearchState.h"
+#include "CardRegistry.h"
+#include "Constants.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Instruction sets the knockout kernels can run on.
+enum KernelIsa : uint8_t {
+    KERNEL_SCALAR,          // Portable loop.
+    KERNEL_AVX2,            // Eight lanes per instruction on x86-64 CPUs with AVX2.
+};
+
+// Returns the best instruction set this CPU supports; detected once.
+KernelIsa detectKernelIsa();
+
+// Knockout questions in structure-of-arrays form. Lane i asks whether
+// damage[i] from an attacker of type attackerType[i] knocks out a defender
+// with hp[i] HP left, weakness weakness[i] and damage reduction reduction[i].
+// Damage is only dealt if it is positive, and weakness adds WEAKNESS_BONUS.
+struct KnockoutLanes {
+    static const int CAPACITY = 64;
+    alignas(32) int32_t damage[CAPACITY];
+    alignas(32) int32_t attackerType[CAPACITY];
+    alignas(32) int32_t hp[CAPACITY];
+    alignas(32) int32_t weakness[CAPACITY];
+    alignas(32) int32_t reduction[CAPACITY];
+    int count = 0;
+};
+
+// Answers every lane at once.
+// Returns:
+// - A mask with bit i set if lane i is a knockout.
+uint64_t knockoutMask(const KnockoutLanes &lanes, KernelIsa isa = detectKernelIsa());
+
+// Scans the card pool's columns for the Pokémon that an attack knocks out
+// from full HP.
+// Parameters:
+// - table: The card pool.
+// - damage: Damage of the attack before weakness.
+// - attackerType: EnergyIndex of the attacker's type, -1 for none.
+// - mask: Output, bit id % 64 of word id / 64 set if card id is knocked out.
+void knockoutCards(const CardTable &table, int damage, int attackerType, std::vector<uint64_t> &mask,
+                   KernelIsa isa = detectKernelIsa());
+
+// Knockouts one side can score this turn: for each of its Pokémon in play and
+// each skill it can pay for, the opposing Pokémon in play that the skill's
+// guaranteed damage knocks out when they face each other. Slots are numbered
+// as in AttackRolls; paralyzed Pokémon score none.
+struct KnockoutMatrix {
+    uint8_t targets[MAX_BENCH + 1][MAX_SKILLS] = {};  // Bit d: knocks out opposing slot d.
+
+    // Returns true if any skill knocks out any opposing Pokémon.
+    bool any() const;
+};
+
+// Fills the knockout matrix of `me` against `opp` with one kernel call.
+void findKnockouts(const CardTable &table, const SideState &me, const SideState &opp, KnockoutMatrix &knockouts,
+                   KernelIsa isa = detectKernelIsa());
+
+// Prints the skills that knock out the opposing Active Pokémon this turn: the
+// player's Active Pokémon's, and its benched Pokémon's after a switch.
+void printKnockouts(std::ostream &out, const CardRegistry &registry, const SideState &me, const SideState &opp);
+
+#endif // KNOCKOUTS_H
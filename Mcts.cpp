@@ -0,0 +1,338 @@
+// Mcts.cpp
+#include "Mcts.h"
+#include "CardRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <omp.h>
+
+// Marks a missing node.
+static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+// Identifies a move independently of hand positions, which differ between
+// sampled positions: hand moves are keyed by the card played.
+static uint32_t moveKey(const SideState &side, const Move &move) {
+    uint32_t card = move.index;
+    switch (move.type) {
+    case MOVE_PLAY_BASIC:
+    case MOVE_EVOLVE:
+    case MOVE_PLAY_ITEM:
+    case MOVE_PLAY_SUPPORTER:
+        card = side.hand[move.index];
+        break;
+    default:
+        break;
+    }
+    return move.type | (static_cast<uint32_t>(move.slot) << 8) | (card << 16);
+}
+
+// A node of the tree: the move sequence from the root to it. Children form a
+// list that only grows at its head, so it can be read without locking.
+struct MctsNode {
+    std::atomic<uint32_t> firstChild{NO_NODE};
+    uint32_t nextSibling = NO_NODE;
+    uint32_t key = 0;                   // moveKey() of the move leading here.
+    uint8_t player = 0;                 // Side that made the move.
+    std::atomic<int32_t> visits{0};
+    std::atomic<double> reward{0.0};    // Summed outcomes for `player`.
+    std::atomic_flag expanding;         // Held while a child is added.
+};
+
+// Fixed-capacity node pool; node 0 is the root. Pools are kept per thread
+// (see threadTree()) and reused by later searches.
+class MctsTree {
+public:
+    // Prepares the pool for a new search with room for `capacity` nodes. The
+    // storage only grows; the nodes of the previous search are cleared.
+    void reset(int capacity) {
+        if (capacity > allocated_) {
+            nodes_.reset(new MctsNode[capacity]);
+            allocated_ = capacity;
+        } else {
+            for (int i = 0, used = size(); i < used; ++i) clearNode(nodes_[i]);
+        }
+        capacity_ = capacity;
+        size_.store(1, std::memory_order_relaxed);
+    }
+
+    MctsNode &operator[](uint32_t id) { return nodes_[id]; }
+
+    // Returns the number of nodes in use.
+    int size() const { return std::min(size_.load(std::memory_order_relaxed), capacity_); }
+
+    // Returns the child of `parent` with the given key, adding it if needed.
+    // Returns NO_NODE if the pool is full.
+    uint32_t findOrAdd(uint32_t parent, uint32_t key, uint8_t player) {
+        MctsNode &node = nodes_[parent];
+        while (node.expanding.test_and_set(std::memory_order_acquire)) {}
+        uint32_t child = node.firstChild.load(std::memory_order_relaxed);
+        while (child != NO_NODE && nodes_[child].key != key) child = nodes_[child].nextSibling;
+        if (child == NO_NODE) {
+            int id = size_.fetch_add(1, std::memory_order_relaxed);
+            if (id < capacity_) {
+                child = static_cast<uint32_t>(id);
+                MctsNode &added = nodes_[child];
+                added.key = key;
+                added.player = player;
+                added.nextSibling = node.firstChild.load(std::memory_order_relaxed);
+                node.firstChild.store(child, std::memory_order_release);
+                countStat(COUNTER_NODES);
+            }
+        }
+        node.expanding.clear(std::memory_order_release);
+        return child;
+    }
+
+private:
+    static void clearNode(MctsNode &node) {
+        node.firstChild.store(NO_NODE, std::memory_order_relaxed);
+        node.nextSibling = NO_NODE;
+        node.key = 0;
+        node.player = 0;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.reward.store(0.0, std::memory_order_relaxed);
+        node.expanding.clear(std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<MctsNode[]> nodes_;
+    int allocated_ = 0;                 // Nodes in the storage.
+    int capacity_ = 0;                  // Nodes the current search may use.
+    std::atomic<int> size_{1};
+};
+
+// Returns the node pool of the calling thread.
+static MctsTree &threadTree() {
+    thread_local MctsTree tree;
+    return tree;
+}
+
+// Picks the move to follow from `parent` in the sampled position: a legal move
+// without a node first, chosen at random, otherwise the UCT maximum over the
+// nodes of the legal moves.
+// Parameters:
+// - tree: The tree.
+// - parent: The current node.
+// - player: The side to move.
+// - me: The side to move in the sampled position.
+// - moves: The legal moves of `me`.
+// - exploration: UCT exploration constant.
+// - rng: Random stream of the iteration.
+// - child: Output, the node of the chosen move, or NO_NODE if the tree is full.
+// - expanded: Output, true if the node was just added.
+// Returns:
+// - The index of the chosen move.
+static int selectMove(MctsTree &tree, uint32_t parent, uint8_t player, const SideState &me, const MoveList &moves,
+                      double exploration, CounterRng &rng, uint32_t &child, bool &expanded) {
+    uint32_t keys[MAX_MOVES];
+    uint32_t nodes[MAX_MOVES];
+    for (int i = 0; i < moves.count; ++i) {
+        keys[i] = moveKey(me, moves.moves[i]);
+        nodes[i] = NO_NODE;
+    }
+    for (uint32_t c = tree[parent].firstChild.load(std::memory_order_acquire); c != NO_NODE; c = tree[c].nextSibling) {
+        for (int i = 0; i < moves.count; ++i) {
+            if (tree[c].key == keys[i]) nodes[i] = c;
+        }
+    }
+
+    int missing[MAX_MOVES];
+    int missingCount = 0;
+    for (int i = 0; i < moves.count; ++i) {
+        if (nodes[i] == NO_NODE) missing[missingCount++] = i;
+    }
+    if (missingCount > 0) {
+        int pick = missing[rng.below(static_cast<uint32_t>(missingCount))];
+        child = tree.findOrAdd(parent, keys[pick], player);
+        expanded = true;
+        if (child != NO_NODE) return pick;
+    }
+
+    // UCT over the moves that have nodes; a virtual loss counts as a visit
+    // without reward, which steers other threads to other moves.
+    expanded = false;
+    double logVisits = std::log(static_cast<double>(std::max(1, tree[parent].visits.load(std::memory_order_relaxed))));
+    int best = -1;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (int i = 0; i < moves.count; ++i) {
+        if (nodes[i] == NO_NODE) continue;
+        const MctsNode &node = tree[nodes[i]];
+        double n = std::max(1, node.visits.load(std::memory_order_relaxed));
+        double score = node.reward.load(std::memory_order_relaxed) / n + exploration * std::sqrt(logVisits / n);
+        if (score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    child = (best >= 0) ? nodes[best] : NO_NODE;
+    return best;
+}
+
+// Runs one iteration: samples the hidden information, descends and expands the
+// tree, plays the game out and backs the outcome up the path.
+// Returns:
+// - The outcome for the player.
+static double runIteration(MctsTree &tree, const CardTable &table, const SearchState &root,
+                           const HiddenDecks &hidden, double exploration, CounterRng &rng) {
+    SearchState game = root;
+    determinize(hidden, game, rng);
+
+    uint32_t path[MCTS_MAX_PATH];
+    int length = 0;
+    path[length++] = 0;
+    tree[0].visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+
+    // The player is in the middle of the root turn, after the draw.
+    int turn = 0;
+    bool turnStarted = true;
+    bool expanded = false;
+    double outcome = gameOutcome(game);
+    while (outcome < 0.0 && !expanded && length < MCTS_MAX_PATH) {
+        if (turn >= MAX_ROLLOUT_TURNS) {
+            outcome = 0.5;
+            break;
+        }
+        SideState &me = game.sides[turn & 1];
+        SideState &opp = game.sides[(turn & 1) ^ 1];
+        if (!turnStarted) {
+            beginTurn(me);
+            turnStarted = true;
+        }
+
+        MoveList moves;
+        generateMoves(table, me, opp, moves);
+        uint32_t child;
+        int choice = selectMove(tree, path[length - 1], static_cast<uint8_t>(turn & 1), me, moves,
+                                exploration, rng, child, expanded);
+        if (child == NO_NODE) break; // Tree full: play out from here.
+        tree[child].visits.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+        path[length++] = child;
+
+        const Move &move = moves.moves[choice];
+        AttackRolls rolls;
+        if (move.type == MOVE_ATTACK) rolls = rollAttack(table[me.active.card].skills[move.index], opp, rng);
+        applyMove(table, me, opp, move, rolls);
+        if (move.type == MOVE_ATTACK || move.type == MOVE_END_TURN) {
+            poisonCheckup(table, me, opp);
+            poisonCheckup(table, opp, me);
+            ++turn;
+            turnStarted = false;
+        }
+        outcome = gameOutcome(game);
+    }
+
+    // Finish the current turn, then the game, with the rollout policy.
+    if (outcome < 0.0 && turnStarted && turn < MAX_ROLLOUT_TURNS) {
+        SideState &me = game.sides[turn & 1];
+        SideState &opp = game.sides[(turn & 1) ^ 1];
+        playTurnGreedy(table, me, opp, rng);
+        poisonCheckup(table, me, opp);
+        poisonCheckup(table, opp, me);
+        ++turn;
+        outcome = gameOutcome(game);
+    }
+    if (outcome < 0.0) outcome = playOutFrom(table, game, turn, rng);
+
+    for (int i = 0; i < length; ++i) {
+        MctsNode &node = tree[path[i]];
+        node.visits.fetch_add(1 - MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+        node.reward.fetch_add(node.player == 0 ? outcome : 1.0 - outcome, std::memory_order_relaxed);
+    }
+    return outcome;
+}
+
+// Adds the statistics of the root's children to the root moves.
+static void collectRootMoves(MctsTree &tree, const SideState &me, const MoveList &moves,
+                             std::vector<MctsMoveStats> &rootMoves) {
+    for (uint32_t c = tree[0].firstChild.load(std::memory_order_acquire); c != NO_NODE; c = tree[c].nextSibling) {
+        for (int i = 0; i < moves.count; ++i) {
+            if (moveKey(me, moves.moves[i]) != tree[c].key) continue;
+            rootMoves[i].visits += tree[c].visits.load(std::memory_order_relaxed);
+            rootMoves[i].value += tree[c].reward.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// Searches the player's next move with Monte Carlo Tree Search.
+MctsResult mctsSearch(const GameState &state, const MctsOptions &options) {
+    SearchStats before = statsSnapshot();
+    MctsResult result;
+    {
+        PhaseTimer timer(PHASE_SEARCH);
+        const CardTable &table = state.cards->table();
+        const SearchState root = toSearchState(state);
+        const HiddenDecks hidden = buildHiddenDecks(state);
+
+        MoveList moves;
+        generateMoves(table, root.sides[0], root.sides[1], moves);
+        result.rootMoves.resize(moves.count);
+        for (int i = 0; i < moves.count; ++i) result.rootMoves[i].move = moves.moves[i];
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.budgetMs);
+        const bool timed = options.budgetMs > 0;
+        std::atomic<int> started{0};
+        std::atomic<int> completed{0};
+        // The tree-parallel tree is the calling thread's pool. In root-parallel
+        // mode every thread grows its own pool, and the node budget is split
+        // between the threads.
+        MctsTree *shared = nullptr;
+        if (options.mode == MCTS_TREE_PARALLEL) {
+            shared = &threadTree();
+            shared->reset(options.maxNodes);
+        }
+
+        #pragma omp parallel
+        {
+            BusyTimer busy;
+            MctsTree *own = nullptr;
+            if (!shared) {
+                own = &threadTree();
+                own->reset(std::max(1, options.maxNodes / omp_get_num_threads()));
+            }
+            MctsTree &tree = shared ? *shared : *own;
+            CounterRng rng;
+
+            for (;;) {
+                int i = started.fetch_add(1, std::memory_order_relaxed);
+                if (options.maxIterations > 0 && i >= options.maxIterations) break;
+                if (timed && std::chrono::steady_clock::now() >= deadline) break;
+                if (!timed && options.maxIterations <= 0) break;
+                rng.reset(options.seed, static_cast<uint64_t>(i));
+                runIteration(tree, table, root, hidden, options.exploration, rng);
+                completed.fetch_add(1, std::memory_order_relaxed);
+                countStat(COUNTER_ROLLOUTS);
+            }
+
+            if (own) {
+                #pragma omp critical(mctsRootMoves)
+                {
+                    collectRootMoves(*own, root.sides[0], moves, result.rootMoves);
+                    result.nodes += own->size();
+                }
+            }
+        }
+        if (shared) {
+            collectRootMoves(*shared, root.sides[0], moves, result.rootMoves);
+            result.nodes = shared->size();
+        }
+        result.iterations = completed.load();
+
+        int best = -1;
+        for (int i = 0; i < moves.count; ++i) {
+            MctsMoveStats &stats = result.rootMoves[i];
+            if (stats.visits > 0) stats.value /= stats.visits;
+            if (best < 0 || stats.visits > result.rootMoves[best].visits) best = i;
+        }
+        double outcome = gameOutcome(root);
+        if (outcome >= 0.0) {
+            result.value = outcome;
+        } else if (best >= 0 && result.rootMoves[best].visits > 0) {
+            result.bestMove = result.rootMoves[best].move;
+            result.value = result.rootMoves[best].value;
+        }
+    }
+    result.stats = statsDifference(statsSnapshot(), before);
+    return result;
+}
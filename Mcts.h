@@ -0,0 +1,59 @@
+// Mcts.h
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "PokemonCard.h"
+#include "MoveGen.h"
+#include "MonteCarlo.h"
+#include "EngineStats.h"
+#include <cstdint>
+#include <vector>
+
+// How the threads of a tree search share work.
+enum MctsMode {
+    MCTS_ROOT_PARALLEL,     // Every thread grows its own tree; root statistics are summed.
+    MCTS_TREE_PARALLEL,     // All threads grow one tree, spread out by virtual loss.
+};
+
+// Settings of a tree search.
+struct MctsOptions {
+    MctsMode mode = MCTS_TREE_PARALLEL;
+    int budgetMs = 1000;            // Time budget of the search.
+    int maxIterations = 0;          // Iteration cap, 0 for none.
+    int maxNodes = MCTS_MAX_NODES;  // Node capacity, split between the trees in root-parallel mode.
+    double exploration = MCTS_EXPLORATION;
+    uint64_t seed = DEFAULT_MONTE_CARLO_SEED;
+};
+
+// Statistics of one move at the root.
+struct MctsMoveStats {
+    Move move;
+    int visits = 0;
+    double value = 0.0;             // Mean outcome for the player after the move.
+};
+
+// Result of a tree search.
+struct MctsResult {
+    Move bestMove;                  // Most visited root move; MOVE_END_TURN if none.
+    double value = 0.0;             // Mean outcome for the player after the best move.
+    int iterations = 0;
+    int nodes = 0;                  // Nodes in the tree, summed over trees.
+    std::vector<MctsMoveStats> rootMoves;   // In generation order.
+    SearchStats stats;
+};
+
+// Searches the player's next move with Monte Carlo Tree Search. Each iteration
+// samples the hidden information (deck orders and the opponent's deck, as the
+// rollouts do), descends the tree with UCT over the legal moves of both
+// players, expands one move and finishes the game with the rollout policy.
+// Tree nodes stand for move sequences, so coin flips and draws are sampled
+// anew on every descent and only moves legal in the sampled position are
+// considered. Iteration i uses random stream i of the seed.
+// Parameters:
+// - state: The current game state; the player is about to move.
+// - options: Mode, budget and tree settings.
+// Returns:
+// - The recommended move and the root statistics.
+MctsResult mctsSearch(const GameState &state, const MctsOptions &options = MctsOptions());
+
+#endif // MCTS_H
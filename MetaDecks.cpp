@@ -0,0 +1,312 @@
+// MetaDecks.cpp
+#include "MetaDecks.h"
+#include "FileParser.h"
+#include "Constants.h"
+#include "Utils.h"
+#include "EngineStats.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string_view>
+
+// Global index of all meta-decks, compiled at program startup.
+MetaDeckIndex allMetaDecks;
+
+// Clears the index and sizes the per-deck bitsets for the registry.
+void MetaDeckIndex::reset(size_t numCards) {
+    numCards_ = numCards;
+    cardWords_ = (numCards + 63) / 64;
+    deckWords_ = 0;
+    deckStart_.assign(1, 0);
+    entries_.clear();
+    deckCards_.clear();
+    decksWithCard_.clear();
+    weights_.clear();
+    energyMasks_.clear();
+}
+
+// Adds a compiled deck list and returns its index.
+uint32_t MetaDeckIndex::addDeck(const MetaDeckCard *cards, size_t count, double weight, uint8_t energyMask) {
+    uint32_t deck = static_cast<uint32_t>(size());
+    deckCards_.resize(deckCards_.size() + cardWords_, 0);
+    uint64_t *bits = deckCards_.data() + deck * cardWords_;
+    for (size_t i = 0; i < count; ++i) {
+        const MetaDeckCard &entry = cards[i];
+        if (entry.card >= numCards_) continue;
+        entries_.push_back(entry);
+        bits[entry.card / 64] |= uint64_t(1) << (entry.card % 64);
+    }
+    deckStart_.push_back(static_cast<uint32_t>(entries_.size()));
+    weights_.push_back(weight);
+    energyMasks_.push_back(energyMask);
+    return deck;
+}
+
+// Returns the number of copies of a card in a deck.
+int MetaDeckIndex::copies(uint32_t deck, CardId card) const {
+    if (!deckContains(deck, card)) return 0;
+    for (uint32_t e = deckStart_[deck]; e < deckStart_[deck + 1]; ++e) {
+        if (entries_[e].card == card) return entries_[e].count;
+    }
+    return 0;
+}
+
+// Builds the inverted index from the per-deck card lists.
+void MetaDeckIndex::finalize() {
+    deckWords_ = (size() + 63) / 64;
+    decksWithCard_.assign(numCards_ * deckWords_, 0);
+    // Each thread fills whole words: the column of 64 decks sharing word w.
+    const long words = static_cast<long>(deckWords_);
+    #pragma omp parallel for schedule(static)
+    for (long w = 0; w < words; ++w) {
+        uint32_t last = std::min<uint32_t>(static_cast<uint32_t>(size()), static_cast<uint32_t>(w + 1) * 64);
+        for (uint32_t deck = static_cast<uint32_t>(w) * 64; deck < last; ++deck) {
+            for (uint32_t e = deckStart_[deck]; e < deckStart_[deck + 1]; ++e) {
+                decksWithCard_[entries_[e].card * deckWords_ + w] |= uint64_t(1) << (deck % 64);
+            }
+        }
+    }
+}
+
+// Writes the bitset of decks that contain every card in `cards` into `out`.
+void MetaDeckIndex::matchAll(const std::vector<CardId> &cards, std::vector<uint64_t> &out) const {
+    out.assign(deckWords_, ~uint64_t(0));
+    if (deckWords_ == 0) return;
+    if (size() % 64 != 0) out.back() = (uint64_t(1) << (size() % 64)) - 1;
+
+    for (CardId card : cards) {
+        if (card >= numCards_) {
+            std::fill(out.begin(), out.end(), 0);
+            return;
+        }
+        const uint64_t *row = decksWithCard_.data() + card * deckWords_;
+        for (size_t w = 0; w < deckWords_; ++w) {
+            out[w] &= row[w];
+        }
+    }
+}
+
+// Decks parsed from one chunk of a meta-deck file, back to back.
+struct MetaDeckChunk {
+    std::vector<MetaDeckCard> cards;
+    std::vector<size_t> deckEnd;             // One past the last card of each deck.
+    std::vector<double> weights;
+    std::vector<uint8_t> energyMasks;
+};
+
+// Parses the decks that start in [begin, end) of the file. The last deck may
+// run past `end` up to its END_DECK line.
+static void parseMetaDeckChunk(std::string_view text, size_t begin, size_t end,
+                               const CardRegistry &registry, MetaDeckChunk &chunk) {
+    const CardTable &table = registry.table();
+    std::string_view rest = text.substr(begin);
+    std::string_view line;
+    size_t deckBegin = 0;
+    double currentWeight = 1.0;
+    bool open = false;
+    while (!rest.empty()) {
+        size_t lineStart = static_cast<size_t>(rest.data() - text.data());
+        if (lineStart >= end && !open) break;
+        nextLine(rest, line);
+        line = trimView(line);
+        if (line == "BEGIN_DECK") {
+            // The next chunk starts here. A deck that was never closed is dropped.
+            if (lineStart >= end) break;
+            chunk.cards.resize(deckBegin);
+            currentWeight = 1.0;
+            open = true;
+        } else if (line == "END_DECK" && open) {
+            uint8_t energyMask = 0;
+            for (size_t i = deckBegin; i < chunk.cards.size(); ++i) {
+                const CardData &card = table[chunk.cards[i].card];
+                if (card.cardType == 0 && card.type >= 0) energyMask |= static_cast<uint8_t>(1u << card.type);
+            }
+            chunk.deckEnd.push_back(chunk.cards.size());
+            chunk.weights.push_back(currentWeight);
+            chunk.energyMasks.push_back(energyMask);
+            deckBegin = chunk.cards.size();
+            open = false;
+        } else if (line.substr(0, 7) == "Weight:") {
+            // Optional prior weight, e.g. the deck's share of the ladder.
+            double weight = 0.0;
+            std::string_view value = trimView(line.substr(7));
+            std::from_chars(value.data(), value.data() + value.size(), weight);
+            currentWeight = std::max(0.0, weight);
+        } else if (open && !line.empty()) {
+            std::string_view name = nextToken(line, ',');
+            std::string_view count = nextToken(line, ',');
+            if (count.empty() || !line.empty()) continue;
+            CardId id = registry.find(name);
+            if (id == NO_CARD) {
+                #pragma omp critical(metaDeckWarnings)
+                std::cerr << "Warning: Meta-deck card '" << name
+                          << "' not found in card database." << std::endl;
+                continue;
+            }
+            chunk.cards.push_back({id, parseIntOrZero(count)});
+        }
+    }
+    chunk.cards.resize(deckBegin);
+}
+
+// Loads all meta-decks from a file and compiles them into `allMetaDecks`.
+void loadAllMetaDecks(const std::string &filename, const CardRegistry &registry) {
+    PhaseTimer timer(PHASE_LOAD);
+    std::string buffer;
+    if (!readWholeFile(filename, buffer)) {
+        std::cerr << "Error: Could not open meta-decks file: " << filename << std::endl;
+        return;
+    }
+
+    // Chunks are parsed in parallel into their own buffers, then appended in
+    // file order so deck indices do not depend on the thread count.
+    std::string_view text(buffer);
+    std::vector<size_t> bounds = splitIntoBlockChunks(text, "BEGIN_DECK", LOAD_CHUNK_BYTES);
+    int chunks = static_cast<int>(bounds.size()) - 1;
+    std::vector<MetaDeckChunk> parsed(chunks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int c = 0; c < chunks; ++c) {
+        parseMetaDeckChunk(text, bounds[c], bounds[c + 1], registry, parsed[c]);
+    }
+
+    allMetaDecks.reset(registry.size());
+    for (const MetaDeckChunk &chunk : parsed) {
+        size_t begin = 0;
+        for (size_t d = 0; d < chunk.deckEnd.size(); ++d) {
+            allMetaDecks.addDeck(chunk.cards.data() + begin, chunk.deckEnd[d] - begin,
+                                 chunk.weights[d], chunk.energyMasks[d]);
+            begin = chunk.deckEnd[d];
+        }
+    }
+    allMetaDecks.finalize();
+}
+
+// Filters meta-decks based on visible Pokémon on the opponent's board.
+std::vector<uint32_t> filterMetaDecksByVisibleBoard(const std::vector<CardId> &visiblePokemons) {
+    PhaseTimer timer(PHASE_FILTER);
+    std::vector<uint64_t> matches;
+    allMetaDecks.matchAll(visiblePokemons, matches);
+
+    std::vector<uint32_t> filteredDecks;
+    for (size_t w = 0; w < matches.size(); ++w) {
+        for (uint64_t bits = matches[w]; bits != 0; bits &= bits - 1) {
+            filteredDecks.push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+        }
+    }
+
+    if (filteredDecks.empty()) {
+        // Return all meta-decks if no matches are found.
+        filteredDecks.resize(allMetaDecks.size());
+        for (uint32_t i = 0; i < filteredDecks.size(); ++i) filteredDecks[i] = i;
+    }
+
+    return filteredDecks;
+}
+
+// Resets the posterior to the prior weights if the meta-decks changed, and
+// makes room in the seen-card counts for cards added to the registry.
+static void ensurePosterior(GameState &state) {
+    OpponentDeckPosterior &post = state.oppDeckPosterior;
+    if (!post.initialized || post.logWeights.size() != allMetaDecks.size()) {
+        post.logWeights.resize(allMetaDecks.size());
+        for (uint32_t deck = 0; deck < allMetaDecks.size(); ++deck) {
+            double w = allMetaDecks.weight(deck);
+            post.logWeights[deck] = (w > 0.0) ? std::log(w) : -std::numeric_limits<double>::infinity();
+        }
+        post.cardsSeen.clear();
+        post.attachmentsSeen = 0;
+        post.attacksSeen = 0;
+        post.initialized = true;
+    }
+    size_t cardCount = state.cards ? state.cards->size() : 0;
+    if (post.cardsSeen.size() < cardCount) post.cardsSeen.resize(cardCount, 0);
+}
+
+// Records that another copy of a card was seen on the opponent's side.
+void observeOpponentCard(GameState &state, CardId card) {
+    ensurePosterior(state);
+    OpponentDeckPosterior &post = state.oppDeckPosterior;
+    if (card >= post.cardsSeen.size()) return;
+
+    // Likelihood of revealing one more copy: proportional to the copies left.
+    int seen = post.cardsSeen[card];
+    const double offMeta = std::log(OFF_META_LIKELIHOOD / DECK_SIZE);
+    for (uint32_t deck = 0; deck < allMetaDecks.size(); ++deck) {
+        int left = allMetaDecks.copies(deck, card) - seen;
+        post.logWeights[deck] += (left > 0) ? std::log(static_cast<double>(left) / DECK_SIZE) : offMeta;
+    }
+    if (post.cardsSeen[card] < UINT8_MAX) ++post.cardsSeen[card];
+}
+
+// Records that the opponent attached an energy of the given type.
+void observeOpponentEnergy(GameState &state, const std::string &energyType) {
+    ensurePosterior(state);
+    int idx = energyIndex(energyType);
+    if (idx < 0) return;
+
+    OpponentDeckPosterior &post = state.oppDeckPosterior;
+    const double offMeta = std::log(OFF_META_LIKELIHOOD);
+    for (uint32_t deck = 0; deck < allMetaDecks.size(); ++deck) {
+        if (!(allMetaDecks.energyMask(deck) & (1u << idx))) post.logWeights[deck] += offMeta;
+    }
+}
+
+// Records that one of the opponent's Pokémon attacked.
+void observeOpponentAttack(GameState &state, CardId attacker) {
+    ensurePosterior(state);
+    OpponentDeckPosterior &post = state.oppDeckPosterior;
+    const double offMeta = std::log(OFF_META_LIKELIHOOD);
+    for (uint32_t deck = 0; deck < allMetaDecks.size(); ++deck) {
+        if (!allMetaDecks.deckContains(deck, attacker)) post.logWeights[deck] += offMeta;
+    }
+}
+
+// Updates the opponent's meta-deck guesses.
+void updateMetaDeckGuesses(GameState &state) {
+    PhaseTimer timer(PHASE_FILTER);
+    ensurePosterior(state);
+    OpponentDeckPosterior &post = state.oppDeckPosterior;
+
+    // Observe board cards beyond the copies already accounted for.
+    std::vector<uint8_t> onBoard(post.cardsSeen.size(), 0);
+    auto countBoard = [&](const BoardPokemon &p) {
+        if (p.id < onBoard.size()) ++onBoard[p.id];
+    };
+    countBoard(state.opponentActivePokemon);
+    for (const auto &benchPoke : state.opponentBench) countBoard(benchPoke);
+    for (CardId id = 0; id < onBoard.size(); ++id) {
+        while (onBoard[id] > post.cardsSeen[id]) observeOpponentCard(state, id);
+    }
+
+    // Observe energy attachments recorded since the last update.
+    for (; post.attachmentsSeen < state.oppAttachments.size(); ++post.attachmentsSeen) {
+        observeOpponentEnergy(state, state.oppAttachments[post.attachmentsSeen].energyType);
+    }
+
+    // Observe attacks recorded since the last update.
+    for (; post.attacksSeen < state.oppAttacks.size(); ++post.attacksSeen) {
+        if (state.cards == nullptr) break;
+        CardId attacker = state.cards->find(state.oppAttacks[post.attacksSeen].attacker);
+        if (attacker != NO_CARD) observeOpponentAttack(state, attacker);
+    }
+
+    // Normalize and rank.
+    state.oppMetaDeckGuesses.clear();
+    if (post.logWeights.empty()) return;
+    double maxLog = *std::max_element(post.logWeights.begin(), post.logWeights.end());
+    if (!std::isfinite(maxLog)) return;
+
+    double total = 0.0;
+    for (double l : post.logWeights) total += std::exp(l - maxLog);
+    for (uint32_t deck = 0; deck < post.logWeights.size(); ++deck) {
+        double p = std::exp(post.logWeights[deck] - maxLog) / total;
+        if (p >= MIN_GUESS_PROBABILITY) state.oppMetaDeckGuesses.push_back({deck, p});
+    }
+    std::sort(state.oppMetaDeckGuesses.begin(), state.oppMetaDeckGuesses.end(),
+              [](const MetaDeckGuess &a, const MetaDeckGuess &b) {
+                  return a.probability > b.probability || (a.probability == b.probability && a.deck < b.deck);
+              });
+}
@@ -0,0 +1,127 @@
+// MetaDecks.h
+#ifndef METADECKS_H
+#define METADECKS_H
+
+#include "PokemonCard.h"
+#include "CardRegistry.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A card entry of a meta-deck list.
+struct MetaDeckCard {
+    CardId card;    // Card in the registry.
+    int count;      // Number of copies in the deck.
+};
+
+// Meta-deck lists compiled against the card registry.
+// Each deck keeps its card list and a bitset of the card IDs it contains, and
+// an inverted index maps every card to the bitset of decks that contain it.
+// Finding the decks consistent with a set of cards is an AND over those rows.
+class MetaDeckIndex {
+public:
+    // Clears the index and sizes the per-deck bitsets for the registry.
+    void reset(size_t numCards);
+
+    // Adds a compiled deck list and returns its index.
+    // Parameters:
+    // - cards: The deck list.
+    // - count: Number of entries in the deck list.
+    // - weight: Prior weight of the deck (how popular it is).
+    // - energyMask: Bit i is set if the deck plays EnergyIndex i.
+    uint32_t addDeck(const MetaDeckCard *cards, size_t count, double weight, uint8_t energyMask);
+
+    // Builds the inverted index. Call once after the last addDeck().
+    void finalize();
+
+    // Writes the bitset of decks that contain every card in `cards` into `out`
+    // (one bit per deck, deckWords() words).
+    void matchAll(const std::vector<CardId> &cards, std::vector<uint64_t> &out) const;
+
+    // Returns true if the deck contains at least one copy of the card.
+    bool deckContains(uint32_t deck, CardId card) const {
+        return card < numCards_ &&
+               ((deckCards_[deck * cardWords_ + card / 64] >> (card % 64)) & 1) != 0;
+    }
+
+    // Returns the number of copies of a card in a deck.
+    int copies(uint32_t deck, CardId card) const;
+
+    // Returns the prior weight of a deck.
+    double weight(uint32_t deck) const { return weights_[deck]; }
+
+    // Returns the energy types a deck plays as a bitmask over EnergyIndex.
+    uint8_t energyMask(uint32_t deck) const { return energyMasks_[deck]; }
+
+    // Returns the card list of a deck as a [begin, end) range.
+    std::pair<const MetaDeckCard *, const MetaDeckCard *> deckCards(uint32_t deck) const {
+        return {entries_.data() + deckStart_[deck], entries_.data() + deckStart_[deck + 1]};
+    }
+
+    size_t size() const { return deckStart_.size() - 1; }
+    size_t deckWords() const { return deckWords_; }
+
+private:
+    size_t numCards_ = 0;
+    size_t cardWords_ = 0;                   // Words per per-deck card bitset.
+    size_t deckWords_ = 0;                   // Words per deck bitset.
+    std::vector<uint32_t> deckStart_{0};     // Offsets into entries_, one past the end per deck.
+    std::vector<MetaDeckCard> entries_;      // Card lists of all decks, back to back.
+    std::vector<uint64_t> deckCards_;        // Per-deck bitsets over card IDs.
+    std::vector<uint64_t> decksWithCard_;    // Per-card bitsets over decks (inverted index).
+    std::vector<double> weights_;            // Prior weight per deck.
+    std::vector<uint8_t> energyMasks_;       // Energy types per deck.
+};
+
+// Meta-decks loaded at program startup.
+extern MetaDeckIndex allMetaDecks;
+
+// Loads all meta-decks from a file and compiles them into `allMetaDecks`.
+// The file is split at BEGIN_DECK lines and the chunks are parsed in parallel;
+// decks keep their file order.
+// Parameters:
+// - filename: The file containing the meta-deck data.
+// - registry: The card registry to resolve card names against.
+void loadAllMetaDecks(const std::string &filename, const CardRegistry &registry);
+
+// Filters meta-decks based on visible Pokémon on the opponent's board.
+// Parameters:
+// - visiblePokemons: The IDs of the visible Pokémon.
+// Returns:
+// - The indices of the meta-decks containing every visible Pokémon, or of all
+//   meta-decks if none match.
+std::vector<uint32_t> filterMetaDecksByVisibleBoard(const std::vector<CardId> &visiblePokemons);
+
+// --- Opponent Deck Posterior ---
+// Observations update the per-deck log-weights in `state.oppDeckPosterior`
+// incrementally; updateMetaDeckGuesses turns them into the ranked
+// distribution in `state.oppMetaDeckGuesses`.
+
+// Records that another copy of a card was seen on the opponent's side.
+// Parameters:
+// - state: The game state holding the posterior.
+// - card: The card that was seen.
+void observeOpponentCard(GameState &state, CardId card);
+
+// Records that the opponent attached an energy of the given type.
+// Parameters:
+// - state: The game state holding the posterior.
+// - energyType: The type of the attached energy.
+void observeOpponentEnergy(GameState &state, const std::string &energyType);
+
+// Records that one of the opponent's Pokémon attacked. This confirms the card
+// is in the deck without revealing another copy.
+// Parameters:
+// - state: The game state holding the posterior.
+// - attacker: The attacking card.
+void observeOpponentAttack(GameState &state, CardId attacker);
+
+// Updates the opponent's meta-deck guesses. Newly visible board cards,
+// energy attachments and attacks are observed first; the posterior is then normalized and
+// ranked into `state.oppMetaDeckGuesses`.
+// Parameters:
+// - state: The current game state to update with meta-deck guesses.
+void updateMetaDeckGuesses(GameState &state);
+
+#endif // METADECKS_H
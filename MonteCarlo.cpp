@@ -0,0 +1,249 @@
+// MonteCarlo.cpp
+#include "MonteCarlo.h"
+#include "Constants.h"
+#include "Rng.h"
+#include "SearchState.h"
+#include "MoveGen.h"
+#include "Knockouts.h"
+#include "CardRegistry.h"
+#include "MetaDecks.h"
+#include "EngineStats.h"
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+// Per-thread scratch space: the root position and the rollout being played.
+struct RolloutScratch {
+    SearchState root;
+    SearchState game;
+};
+
+// Draws the random results an attack's effect program depends on.
+AttackRolls rollAttack(const SkillData &skill, const SideState &def, CounterRng &rng) {
+    AttackRolls rolls;
+    for (int i = 0; i < skill.opCount; ++i) {
+        const EffectOp &op = skill.ops[i];
+        switch (op.opcode) {
+        case OP_FLIP_N:
+            for (int f = 0; f < op.count; ++f) rolls.heads += rng.coinFlip() ? 1 : 0;
+            break;
+        case OP_FLIP_UNTIL_TAILS:
+            while (rolls.heads < MAX_FLIP && rng.coinFlip()) ++rolls.heads;
+            break;
+        case OP_RANDOM_HITS:
+            for (int h = 0; h < op.count; ++h) {
+                ++rolls.randomHits[rng.below(static_cast<uint32_t>(def.benchCount + 1))];
+            }
+            break;
+        case OP_SHUFFLE_BACK:
+            if (rolls.heads > 0) rolls.shufflePos = static_cast<int>(rng.below(static_cast<uint32_t>(def.deckCount + 1)));
+            break;
+        case OP_SWITCH_OUT:
+            if (def.benchCount > 0) rolls.switchSlot = static_cast<int>(rng.below(static_cast<uint32_t>(def.benchCount)));
+            break;
+        default:
+            break;
+        }
+    }
+    return rolls;
+}
+
+// Applies poison damage to an Active Pokémon between turns.
+void poisonCheckup(const CardTable &table, SideState &side, SideState &other) {
+    if (side.active.card != NO_CARD && (side.active.status & STATUS_POISONED)) {
+        side.active.hp -= POISON_DAMAGE;
+        resolveKnockouts(table, other, side);
+    }
+}
+
+// Returns the index of the usable skill with the highest expected damage, or -1.
+// If some skills surely knock out the defending Active, picks among those.
+static int bestSkill(const CardTable &table, const SideState &me, const SideState &opp, bool usableOnly,
+                     const KnockoutMatrix *knockouts = nullptr) {
+    const CardData &card = table[me.active.card];
+    bool sureKnockout = false;
+    for (int i = 0; knockouts != nullptr && i < card.skillCount; ++i) sureKnockout |= knockouts->targets[0][i] & 1;
+    int best = -1;
+    double bestDamage = -1.0;
+    for (int i = 0; i < card.skillCount; ++i) {
+        if (usableOnly && !canAfford(me.active, card.skills[i])) continue;
+        if (sureKnockout && !(knockouts->targets[0][i] & 1)) continue;
+        double dmg = expectedSkillDamage(table, card.skills[i], me.active, opp.active);
+        if (dmg > bestDamage) {
+            best = i;
+            bestDamage = dmg;
+        }
+    }
+    return best;
+}
+
+// Plays the rest of a turn for `me` with the greedy rollout policy.
+void playTurnGreedy(const CardTable &table, SideState &me, SideState &opp, CounterRng &rng) {
+    // Put Basic Pokémon into play, filling the Active spot first.
+    for (int i = 0; i < me.handCount;) {
+        CardId id = me.hand[i];
+        if (isBasicPokemon(table[id]) && (me.active.card == NO_CARD || me.benchCount < MAX_BENCH)) {
+            SlotState placed;
+            placed.card = id;
+            placed.hp = table[id].hp;
+            placed.turnFlags = SLOT_ENTERED_THIS_TURN;
+            if (me.active.card == NO_CARD) me.active = placed; else me.bench[me.benchCount++] = placed;
+            me.hand[i] = me.hand[--me.handCount];
+        } else {
+            ++i;
+        }
+    }
+    if (me.active.card == NO_CARD) return;
+
+    // Evolve each Pokémon in play at most once.
+    bool evolved[MAX_BENCH + 1] = {};
+    for (int i = 0; i < me.handCount;) {
+        const CardData &card = table[me.hand[i]];
+        bool used = false;
+        if (card.cardType == 0 && card.prevEvo != NO_CARD) {
+            for (int s = 0; s <= me.benchCount && !used; ++s) {
+                SlotState &slot = (s == 0) ? me.active : me.bench[s - 1];
+                if (!evolved[s] && slot.card == card.prevEvo && !(slot.turnFlags & SLOT_ENTERED_THIS_TURN)) {
+                    slot.hp = static_cast<int16_t>(slot.hp + card.hp - table[slot.card].hp);
+                    slot.card = me.hand[i];
+                    slot.status = 0;
+                    evolved[s] = used = true;
+                }
+            }
+        }
+        if (used) me.hand[i] = me.hand[--me.handCount]; else ++i;
+    }
+
+    // Energy goes to the Active Pokémon until it can use its strongest attack.
+    if (me.energyType >= 0 && !(me.turnFlags & TURN_ENERGY_ATTACHED)) {
+        int wanted = bestSkill(table, me, opp, false);
+        SlotState *target = &me.active;
+        if ((wanted < 0 || canAfford(me.active, table[me.active.card].skills[wanted])) && me.benchCount > 0) {
+            target = &me.bench[0];
+        }
+        target->energy.add(me.energyType);
+    }
+
+    if (!(me.active.status & STATUS_PARALYZED) && opp.active.card != NO_CARD) {
+        KnockoutMatrix knockouts;
+        findKnockouts(table, me, opp, knockouts);
+        int skill = bestSkill(table, me, opp, true, &knockouts);
+        if (skill >= 0) {
+            const SkillData &used = table[me.active.card].skills[skill];
+            resolveAttack(table, me, opp, used, rollAttack(used, opp, rng));
+        }
+    }
+
+    // Paralysis and supporter bans last until the end of the owner's turn.
+    endTurn(me);
+}
+
+// Plays a game out with the greedy policy, starting with the given turn.
+double playOutFrom(const CardTable &table, SearchState &game, int turn, CounterRng &rng) {
+    for (; turn < MAX_ROLLOUT_TURNS; ++turn) {
+        SideState &me = game.sides[turn & 1];
+        SideState &opp = game.sides[(turn & 1) ^ 1];
+        beginTurn(me);
+        playTurnGreedy(table, me, opp, rng);
+        poisonCheckup(table, me, opp);
+        poisonCheckup(table, opp, me);
+        double outcome = gameOutcome(game);
+        if (outcome >= 0.0) return outcome;
+    }
+    return 0.5;
+}
+
+// Samples the hidden information of a position.
+void determinize(const HiddenDecks &hidden, SearchState &game, CounterRng &rng) {
+    if (!hidden.decks.empty()) {
+        double pick = rng.nextDouble() * hidden.cumulative.back();
+        size_t i = std::upper_bound(hidden.cumulative.begin(), hidden.cumulative.end(), pick) - hidden.cumulative.begin();
+        const HiddenDeck &deck = hidden.decks[std::min(i, hidden.decks.size() - 1)];
+        SideState &opp = game.sides[1];
+        std::copy(deck.cards, deck.cards + deck.count, opp.deck);
+        opp.deckCount = static_cast<uint8_t>(deck.count);
+    }
+    for (auto &side : game.sides) {
+        for (int i = side.deckCount - 1; i > 0; --i) {
+            std::swap(side.deck[i], side.deck[rng.below(static_cast<uint32_t>(i + 1))]);
+        }
+    }
+}
+
+// Plays one rollout from the scratch root position. Returns the outcome for
+// the player.
+static double playOut(const CardTable &table, RolloutScratch &scratch, CounterRng &rng, const HiddenDecks &hidden) {
+    scratch.game = scratch.root;
+    determinize(hidden, scratch.game, rng);
+    return playOutFrom(table, scratch.game, 0, rng);
+}
+
+// Builds the opponent's hidden deck for each of the most likely meta-decks.
+HiddenDecks buildHiddenDecks(const GameState &state) {
+    HiddenDecks hidden;
+    std::vector<HiddenDeck> &hiddenDecks = hidden.decks;
+    std::vector<double> &cumulative = hidden.cumulative;
+    const std::vector<uint8_t> &seen = state.oppDeckPosterior.cardsSeen;
+    double total = 0.0;
+    for (const auto &guess : state.oppMetaDeckGuesses) {
+        if (hiddenDecks.size() == static_cast<size_t>(MAX_SAMPLED_DECKS)) break;
+        if (guess.deck >= allMetaDecks.size()) continue;
+
+        HiddenDeck deck;
+        auto range = allMetaDecks.deckCards(guess.deck);
+        for (const MetaDeckCard *entry = range.first; entry != range.second; ++entry) {
+            int left = entry->count - (entry->card < seen.size() ? seen[entry->card] : 0);
+            for (int c = 0; c < left && deck.count < DECK_SIZE; ++c) {
+                deck.cards[deck.count++] = entry->card;
+            }
+        }
+        total += guess.probability;
+        hiddenDecks.push_back(deck);
+        cumulative.push_back(total);
+    }
+    return hidden;
+}
+
+// Runs a Monte Carlo simulation over the game state.
+MonteCarloResult monteCarloSimulation(const GameState &state, int numSimulations, uint64_t seed) {
+    MonteCarloResult result;
+    if (numSimulations <= 0) return result;
+
+    PhaseTimer timer(PHASE_ROLLOUT);
+    const CardTable &table = state.cards->table();
+    const SearchState root = toSearchState(state);
+
+    const HiddenDecks hidden = buildHiddenDecks(state);
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+
+    #pragma omp parallel reduction(+:sum, sumSq)
+    {
+        // Thread-local scratch and random stream; the card table is read-only.
+        RolloutScratch scratch;
+        scratch.root = root;
+        CounterRng rng;
+        BusyTimer busy;
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < numSimulations; ++i) {
+            rng.reset(seed, static_cast<uint64_t>(i));
+            double outcome = playOut(table, scratch, rng, hidden);
+            sum += outcome;
+            sumSq += outcome * outcome;
+            countStat(COUNTER_ROLLOUTS);
+        }
+    }
+
+    double n = static_cast<double>(numSimulations);
+    double mean = sum / n;
+    double variance = std::max(0.0, sumSq / n - mean * mean);
+    double halfWidth = 1.96 * std::sqrt(variance / n);
+
+    result.winRate = mean;
+    result.ciLow = std::max(0.0, mean - halfWidth);
+    result.ciHigh = std::min(1.0, mean + halfWidth);
+    result.simulations = numSimulations;
+    return result;
+}
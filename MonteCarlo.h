@@ -0,0 +1,80 @@
+// MonteCarlo.h
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "PokemonCard.h"
+#include "SearchState.h"
+#include "Rng.h"
+#include <cstdint>
+#include <vector>
+
+// Seed used when the caller does not supply one, so repeated runs agree.
+const uint64_t DEFAULT_MONTE_CARLO_SEED = 0x5443475F504C5553ULL;
+
+// Aggregated result of a batch of Monte Carlo rollouts.
+struct MonteCarloResult {
+    double winRate = 0.0;   // Mean outcome for the player (win = 1, draw = 0.5, loss = 0).
+    double ciLow = 0.0;     // Lower bound of the 95% confidence interval.
+    double ciHigh = 0.0;    // Upper bound of the 95% confidence interval.
+    int simulations = 0;    // Number of rollouts played.
+};
+
+// Runs a Monte Carlo simulation over the game state.
+// Each rollout shuffles the player's unseen deck and plays the game out with a
+// greedy policy, resolving coin flips, poison, paralysis and bench damage from
+// the parsed skill effects. The opponent's hidden deck is sampled from the
+// meta-deck posterior in `state.oppMetaDeckGuesses`, if there is one. Rollout
+// i always uses random stream i of the seed, so the result does not depend on
+// the number of threads.
+// Parameters:
+// - state: The current game state.
+// - numSimulations: The number of rollouts to play.
+// - seed: Seed for the counter-based random streams.
+// Returns:
+// - The win rate with its 95% confidence interval.
+MonteCarloResult monteCarloSimulation(const GameState &state, int numSimulations,
+                                      uint64_t seed = DEFAULT_MONTE_CARLO_SEED);
+
+// --- Rollout Building Blocks ---
+// Shared with the tree search, which plays its own moves and hands the rest
+// of the game to the rollout policy.
+
+// Hidden part of a meta-deck the opponent may be playing: the list minus the
+// cards already seen on the opponent's side.
+struct HiddenDeck {
+    CardId cards[DECK_SIZE];
+    int count = 0;
+};
+
+// Opponent decks a rollout samples from, with their cumulative posterior weight.
+struct HiddenDecks {
+    std::vector<HiddenDeck> decks;
+    std::vector<double> cumulative;
+};
+
+// Builds the opponent's hidden deck for each of the MAX_SAMPLED_DECKS most
+// likely meta-decks in `state.oppMetaDeckGuesses`.
+HiddenDecks buildHiddenDecks(const GameState &state);
+
+// Samples the hidden information of a position: picks the opponent's deck from
+// `hidden` by weight, if there is one, and shuffles both decks.
+void determinize(const HiddenDecks &hidden, SearchState &game, CounterRng &rng);
+
+// Draws the random results an attack's effect program depends on.
+AttackRolls rollAttack(const SkillData &skill, const SideState &def, CounterRng &rng);
+
+// Applies poison damage to an Active Pokémon between turns.
+void poisonCheckup(const CardTable &table, SideState &side, SideState &other);
+
+// Plays the rest of a turn for `me` with the greedy rollout policy: bench
+// Basics, evolve, attach energy unless already attached, and use the attack
+// with the highest expected damage.
+void playTurnGreedy(const CardTable &table, SideState &me, SideState &opp, CounterRng &rng);
+
+// Plays a game out with the greedy policy, starting with turn `turn` (side
+// turn % 2 to move, before its draw) and stopping after MAX_ROLLOUT_TURNS.
+// Returns:
+// - The outcome for side 0.
+double playOutFrom(const CardTable &table, SearchState &game, int turn, CounterRng &rng);
+
+#endif // MONTECARLO_H
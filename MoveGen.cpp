@@ -0,0 +1,202 @@
+// MoveGen.cpp
+#include "MoveGen.h"
+#include "CardRegistry.h"
+#include <utility>
+
+// Returns the board slot with the given number.
+static inline const SlotState &slotAt(const SideState &side, int slot) {
+    return (slot == 0) ? side.active : side.bench[slot - 1];
+}
+
+static inline SlotState &slotAt(SideState &side, int slot) {
+    return (slot == 0) ? side.active : side.bench[slot - 1];
+}
+
+// Returns true if an earlier hand position holds the same card, so that
+// identical cards produce one move.
+static bool seenEarlierInHand(const SideState &side, int index) {
+    for (int j = 0; j < index; ++j) {
+        if (side.hand[j] == side.hand[index]) return true;
+    }
+    return false;
+}
+
+// Returns true if the Active Pokémon can pay for retreating.
+static bool canRetreat(const CardTable &table, const SideState &me) {
+    return me.active.card != NO_CARD && me.benchCount > 0 && !(me.turnFlags & TURN_RETREATED) &&
+           !(me.active.status & STATUS_PARALYZED) && totalEnergy(me.active) >= table[me.active.card].retreatCost;
+}
+
+// Returns true if `slot` holds the Pokémon the card evolves from and may evolve.
+static bool canEvolve(const CardData &card, const SlotState &slot) {
+    return card.cardType == 0 && card.prevEvo != NO_CARD && slot.card == card.prevEvo &&
+           !(slot.turnFlags & SLOT_ENTERED_THIS_TURN);
+}
+
+// Generates every legal move of `me` in the current turn.
+void generateMoves(const CardTable &table, const SideState &me, const SideState &opp, MoveList &moves) {
+    moves.count = 0;
+    const bool hasActive = me.active.card != NO_CARD;
+    const int slots = hasActive ? me.benchCount + 1 : 0;
+
+    if (hasActive && opp.active.card != NO_CARD && !(me.active.status & STATUS_PARALYZED)) {
+        const CardData &card = table[me.active.card];
+        for (int i = 0; i < card.skillCount; ++i) {
+            if (canAfford(me.active, card.skills[i])) moves.add(MOVE_ATTACK, static_cast<uint8_t>(i), 0);
+        }
+    }
+
+    if (me.energyType >= 0 && !(me.turnFlags & TURN_ENERGY_ATTACHED)) {
+        for (int s = 0; s < slots; ++s) moves.add(MOVE_ATTACH_ENERGY, 0, static_cast<uint8_t>(s));
+    }
+
+    for (int i = 0; i < me.handCount; ++i) {
+        if (seenEarlierInHand(me, i)) continue;
+        const CardData &card = table[me.hand[i]];
+        const uint8_t index = static_cast<uint8_t>(i);
+        if (card.cardType == 1) {
+            if (!me.supporterBanned && !(me.turnFlags & TURN_SUPPORTER_PLAYED)) moves.add(MOVE_PLAY_SUPPORTER, index, 0);
+        } else if (card.cardType == 2) {
+            moves.add(MOVE_PLAY_ITEM, index, 0);
+        } else if (isBasicPokemon(card)) {
+            if (!hasActive || me.benchCount < MAX_BENCH) moves.add(MOVE_PLAY_BASIC, index, 0);
+        } else {
+            for (int s = 0; s < slots; ++s) {
+                if (canEvolve(card, slotAt(me, s))) moves.add(MOVE_EVOLVE, index, static_cast<uint8_t>(s));
+            }
+        }
+    }
+
+    if (canRetreat(table, me)) {
+        for (int s = 1; s < slots; ++s) moves.add(MOVE_RETREAT, 0, static_cast<uint8_t>(s));
+    }
+
+    moves.add(MOVE_END_TURN, 0, 0);
+}
+
+// Returns true if `move` is legal for `me`.
+bool isLegalMove(const CardTable &table, const SideState &me, const SideState &opp, const Move &move) {
+    const bool hasActive = me.active.card != NO_CARD;
+    const int slots = hasActive ? me.benchCount + 1 : 0;
+    const bool inHand = move.index < me.handCount;
+    switch (move.type) {
+    case MOVE_ATTACK:
+        return hasActive && opp.active.card != NO_CARD && !(me.active.status & STATUS_PARALYZED) &&
+               move.index < table[me.active.card].skillCount &&
+               canAfford(me.active, table[me.active.card].skills[move.index]);
+    case MOVE_ATTACH_ENERGY:
+        return me.energyType >= 0 && !(me.turnFlags & TURN_ENERGY_ATTACHED) && move.slot < slots;
+    case MOVE_PLAY_BASIC:
+        return inHand && isBasicPokemon(table[me.hand[move.index]]) && (!hasActive || me.benchCount < MAX_BENCH);
+    case MOVE_EVOLVE:
+        return inHand && move.slot < slots && canEvolve(table[me.hand[move.index]], slotAt(me, move.slot));
+    case MOVE_RETREAT:
+        return move.slot >= 1 && move.slot < slots && canRetreat(table, me);
+    case MOVE_PLAY_ITEM:
+        return inHand && table[me.hand[move.index]].cardType == 2;
+    case MOVE_PLAY_SUPPORTER:
+        return inHand && table[me.hand[move.index]].cardType == 1 && !me.supporterBanned &&
+               !(me.turnFlags & TURN_SUPPORTER_PLAYED);
+    case MOVE_END_TURN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Removes the card at a hand position.
+static void removeFromHand(SideState &side, int index) {
+    side.hand[index] = side.hand[--side.handCount];
+}
+
+// Applies a legal move.
+void applyMove(const CardTable &table, SideState &me, SideState &opp, const Move &move, const AttackRolls &rolls) {
+    switch (move.type) {
+    case MOVE_ATTACK:
+        resolveAttack(table, me, opp, table[me.active.card].skills[move.index], rolls);
+        endTurn(me);
+        break;
+    case MOVE_ATTACH_ENERGY:
+        slotAt(me, move.slot).energy.add(me.energyType);
+        me.turnFlags |= TURN_ENERGY_ATTACHED;
+        break;
+    case MOVE_PLAY_BASIC: {
+        SlotState placed;
+        placed.card = me.hand[move.index];
+        placed.hp = table[placed.card].hp;
+        placed.turnFlags = SLOT_ENTERED_THIS_TURN;
+        if (me.active.card == NO_CARD) me.active = placed; else me.bench[me.benchCount++] = placed;
+        removeFromHand(me, move.index);
+        break;
+    }
+    case MOVE_EVOLVE: {
+        SlotState &slot = slotAt(me, move.slot);
+        CardId evolution = me.hand[move.index];
+        // Damage taken carries over to the evolution; conditions are removed.
+        slot.hp = static_cast<int16_t>(slot.hp + table[evolution].hp - table[slot.card].hp);
+        slot.card = evolution;
+        slot.status = 0;
+        slot.turnFlags |= SLOT_ENTERED_THIS_TURN;
+        removeFromHand(me, move.index);
+        break;
+    }
+    case MOVE_RETREAT:
+        discardEnergy(me.active, table[me.active.card].retreatCost);
+        // Special conditions end when the Pokémon moves to the bench.
+        me.active.status = 0;
+        std::swap(me.active, me.bench[move.slot - 1]);
+        me.turnFlags |= TURN_RETREATED;
+        break;
+    case MOVE_PLAY_ITEM:
+        removeFromHand(me, move.index);
+        break;
+    case MOVE_PLAY_SUPPORTER:
+        removeFromHand(me, move.index);
+        me.turnFlags |= TURN_SUPPORTER_PLAYED;
+        break;
+    case MOVE_END_TURN:
+        endTurn(me);
+        break;
+    default:
+        break;
+    }
+}
+
+// Describes a move for display.
+std::string describeMove(const CardRegistry &registry, const SideState &me, const Move &move) {
+    auto name = [&registry](CardId id) { return std::string(registry.name(id)); };
+    switch (move.type) {
+    case MOVE_ATTACK:
+        return name(me.active.card) + " uses " + std::string(registry.skillName(me.active.card, move.index));
+    case MOVE_ATTACH_ENERGY:
+        return "Attach energy to " + name(slotAt(me, move.slot).card);
+    case MOVE_EVOLVE:
+        return "Evolve " + name(slotAt(me, move.slot).card) + " into " + name(me.hand[move.index]);
+    case MOVE_RETREAT:
+        return "Retreat " + name(me.active.card) + " for " + name(slotAt(me, move.slot).card);
+    case MOVE_PLAY_BASIC:
+    case MOVE_PLAY_ITEM:
+    case MOVE_PLAY_SUPPORTER:
+        return "Play " + name(me.hand[move.index]);
+    default:
+        return "End turn";
+    }
+}
+
+// Starts the turn of a side.
+void beginTurn(SideState &side) {
+    if (side.deckCount > 0 && side.handCount < MAX_HAND_SIZE) {
+        side.hand[side.handCount++] = side.deck[--side.deckCount];
+    }
+    side.active.damageReduction = 0;
+    for (int i = 0; i < side.benchCount; ++i) side.bench[i].damageReduction = 0;
+}
+
+// Ends the turn of a side.
+void endTurn(SideState &side) {
+    side.active.status &= static_cast<uint8_t>(~STATUS_PARALYZED);
+    side.active.turnFlags = 0;
+    for (int i = 0; i < side.benchCount; ++i) side.bench[i].turnFlags = 0;
+    side.supporterBanned = false;
+    side.turnFlags = 0;
+}
@@ -0,0 +1,87 @@
+// MoveGen.h
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "SearchState.h"
+#include "Constants.h"
+#include <cstdint>
+#include <string>
+
+// Kinds of moves a player can make during their turn.
+enum MoveType : uint8_t {
+    MOVE_ATTACK,            // Use skill `index` of the Active Pokémon; ends the turn.
+    MOVE_ATTACH_ENERGY,     // Attach the Energy Zone's energy to `slot`.
+    MOVE_PLAY_BASIC,        // Put the Basic Pokémon at hand position `index` into play.
+    MOVE_EVOLVE,            // Evolve `slot` with the card at hand position `index`.
+    MOVE_RETREAT,           // Switch the Active Pokémon with benched Pokémon `slot` - 1.
+    MOVE_PLAY_ITEM,         // Play the Item at hand position `index`.
+    MOVE_PLAY_SUPPORTER,    // Play the Supporter at hand position `index`.
+    MOVE_END_TURN,          // End the turn without attacking.
+};
+
+// One move. Slots are numbered as in AttackRolls: 0 is the Active spot and
+// i is bench position i - 1.
+struct Move {
+    uint8_t type = MOVE_END_TURN;   // MoveType.
+    uint8_t index = 0;              // Skill index or hand position.
+    uint8_t slot = 0;               // Target slot.
+};
+
+// Fixed-capacity buffer of moves; generating moves never allocates.
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void add(uint8_t type, uint8_t index, uint8_t slot) { moves[count++] = Move{type, index, slot}; }
+    const Move *begin() const { return moves; }
+    const Move *end() const { return moves + count; }
+};
+
+// Generates every legal move of `me` in the current turn:
+// - attacks whose energy cost the Active Pokémon pays, unless it is paralyzed
+//   or the opponent has no Active Pokémon;
+// - attaching the Energy Zone's energy to any Pokémon in play, once per turn;
+// - putting Basic Pokémon from the hand into play while the bench has room;
+// - evolving a Pokémon in play that did not enter play this turn;
+// - retreating to any benched Pokémon once per turn, if the Active Pokémon is
+//   not paralyzed and has energy for the retreat cost;
+// - playing Items, and one Supporter per turn unless Supporters are banned;
+// - ending the turn.
+// Identical cards in the hand produce one move each.
+// Parameters:
+// - table: The card table both sides refer to.
+// - me: The side to move.
+// - opp: The other side.
+// - moves: Output, the legal moves.
+void generateMoves(const CardTable &table, const SideState &me, const SideState &opp, MoveList &moves);
+
+// Returns true if `move` is legal for `me`.
+bool isLegalMove(const CardTable &table, const SideState &me, const SideState &opp, const Move &move);
+
+// Applies a legal move. Attacks resolve with the given random results; attacks
+// and MOVE_END_TURN end the turn of `me` (see endTurn()). The card data has no
+// Trainer effects, so playing an Item or Supporter only discards it.
+// Parameters:
+// - table: The card table both sides refer to.
+// - me: The side to move.
+// - opp: The other side.
+// - move: The move to apply.
+// - rolls: The random results of an attack.
+void applyMove(const CardTable &table, SideState &me, SideState &opp, const Move &move,
+               const AttackRolls &rolls = AttackRolls());
+
+// Describes a move for display, e.g. "Attach energy to Pikachu ex".
+// Parameters:
+// - registry: The card registry to name cards.
+// - me: The side the move was generated for.
+// - move: The move.
+std::string describeMove(const CardRegistry &registry, const SideState &me, const Move &move);
+
+// Starts the turn of a side: draws a card and ends the damage reductions of
+// the previous turn.
+void beginTurn(SideState &side);
+
+// Ends the turn of a side: paralysis, supporter bans and turn flags expire.
+void endTurn(SideState &side);
+
+#endif // MOVEGEN_H
@@ -2,22 +2,29 @@
 #ifndef POKEMONCARD_H
 #define POKEMONCARD_H
 
+#include "Energy.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// Dense integer index of a card in a card table.
+using CardId = std::uint16_t;
+const CardId NO_CARD = 0xFFFF;             // Marks an empty slot.
+
 // Forward declarations
 struct Skill;
 struct Ability;
+class CardRegistry;
 
 // --- Energy and Skill Structures ---
 
 // Represents the energy type and amount required for a skill.
 struct EnergyRequirement {
-    std::string energyType;  // e.g., "Grass", "Fire", "Any"
+    int8_t type;             // EnergyIndex; ENERGY_COLORLESS for "Colorless" and "Any".
     int amount;              // Amount of energy required.
 
     EnergyRequirement(const std::string &etype = "", int amt = 0)
-        : energyType(etype), amount(amt) {}
+        : type(static_cast<int8_t>(energyIndex(etype))), amount(amt) {}
 };
 
 // Specifies additional effects that a skill can have during an attack.
@@ -178,10 +185,6 @@ struct Pokemon {
     std::string weakness;                      // Weakness type (e.g., Fire).
     int retreatCost;                           // Energy cost to retreat the Pokémon.
 
-    std::vector<EnergyRequirement> attachedEnergy; // Energy cards attached to the Pokémon.
-    bool isPoisoned;                           // Whether the Pokémon is poisoned.
-    bool isParalyzed;                          // Whether the Pokémon is paralyzed.
-
     Pokemon(const std::string &n = "", bool ex = false,
             const std::string &t = "", const std::string &pkg = "",
             bool evolve = false, int cType = 0,
@@ -190,8 +193,20 @@ struct Pokemon {
       : name(n), isEx(ex), type(t), package(pkg), canEvolve(evolve), cardType(cType),
         hp(health), stage(stg), prevEvo(""), nextEvo(""),
         preEvolution(nullptr), postEvolution(nullptr),
-        skills(), abilities(), weakness(weak), retreatCost(0),
-        attachedEnergy(), isPoisoned(false), isParalyzed(false)
+        skills(), abilities(), weakness(weak), retreatCost(0)
+    {}
+};
+
+// A card in play: the card's ID plus the attributes that change during a game.
+struct BoardPokemon {
+    CardId id;                                 // Card in the registry, NO_CARD for an empty slot.
+    int hp;                                    // Remaining hit points.
+    EnergyCounts attachedEnergy;               // Energy attached to the Pokémon, per type.
+    bool isPoisoned;                           // Whether the Pokémon is poisoned.
+    bool isParalyzed;                          // Whether the Pokémon is paralyzed.
+
+    BoardPokemon(CardId cardId = NO_CARD, int health = 0)
+      : id(cardId), hp(health), attachedEnergy(), isPoisoned(false), isParalyzed(false)
     {}
 };
 
@@ -210,24 +225,49 @@ struct EnergyAttachment {
     int amount;                                // Amount of energy attached.
 };
 
-// Represents the current game state.
+// Probability that the opponent is playing a given meta-deck.
+struct MetaDeckGuess {
+    uint32_t deck;                             // Index of the meta-deck.
+    double probability;                        // Posterior probability.
+};
+
+// Incremental posterior over the meta-deck the opponent is playing.
+// Every observation adds its log-likelihood to the per-deck weights.
+struct OpponentDeckPosterior {
+    std::vector<double> logWeights;            // Unnormalized log-weight per meta-deck.
+    std::vector<uint8_t> cardsSeen;            // Copies of each card observed so far, by CardId.
+    size_t attachmentsSeen = 0;                // Entries of oppAttachments already applied.
+    size_t attacksSeen = 0;                    // Entries of oppAttacks already applied.
+    bool initialized = false;                  // Whether the prior weights have been set.
+};
+
+// Represents the current game state. Cards are referenced by their ID in the
+// card registry.
 struct GameState {
-    std::vector<Pokemon> deck;                 // Player's deck of cards.
-    std::vector<Pokemon> hand;                 // Player's hand of cards.
-    Pokemon activePokemon;                     // Player's active Pokémon.
-    std::vector<Pokemon> bench;                // Player's benched Pokémon.
+    const CardRegistry *cards;                 // Registry the card IDs refer to.
+    std::vector<CardId> deck;                  // Player's deck of cards.
+    std::vector<CardId> hand;                  // Player's hand of cards.
+    BoardPokemon activePokemon;                // Player's active Pokémon.
+    std::vector<BoardPokemon> bench;           // Player's benched Pokémon.
     int turn;                                  // Current turn number.
     bool firstTurn;                            // Whether it is the first turn.
-    Pokemon opponentActivePokemon;             // Opponent's active Pokémon.
-    std::vector<Pokemon> opponentBench;        // Opponent's benched Pokémon.
+    bool goingFirst;                           // Whether the player won the opening coin flip.
+    int yourPoints;                            // Points scored by the player.
+    int opponentPoints;                        // Points scored by the opponent.
+    std::string opponentEnergyType;            // Opponent's main energy type.
+    BoardPokemon opponentActivePokemon;        // Opponent's active Pokémon.
+    std::vector<BoardPokemon> opponentBench;   // Opponent's benched Pokémon.
     std::vector<std::string> actionHistory;    // History of actions taken.
 
     std::vector<AttackRecord> attacksThisRound; // List of attacks performed this round.
     std::vector<EnergyAttachment> yourAttachments; // Energy attachments on the player's side.
     std::vector<EnergyAttachment> oppAttachments;  // Energy attachments on the opponent's side.
-    std::vector<std::string> oppMetaDeckGuesses;   // Guesses for the opponent's meta-deck.
+    std::vector<AttackRecord> oppAttacks;          // Attacks made by the opponent so far.
+    OpponentDeckPosterior oppDeckPosterior;        // Posterior over the opponent's meta-deck.
+    std::vector<MetaDeckGuess> oppMetaDeckGuesses; // Opponent's meta-deck, most likely first.
 
-    GameState() : turn(0), firstTurn(true) {}
+    GameState()
+      : cards(nullptr), turn(0), firstTurn(true), goingFirst(true), yourPoints(0), opponentPoints(0) {}
 };
 
 #endif // POKEMONCARD_H
@@ -0,0 +1,73 @@
+// Rng.h
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// Counter-based random number generator (Philox4x32-10).
+// Every (key, counter) pair maps to an independent block of four 32-bit values,
+// so a stream is fully determined by its seed and stream index. Simulations key
+// one stream per rollout, which keeps results identical for any thread count.
+struct CounterRng {
+    uint32_t key[2];        // Derived from the seed.
+    uint32_t counter[4];    // Block counter (low words) and stream index (high words).
+    uint32_t block[4];      // Current output block.
+    int used;               // Number of values consumed from the current block.
+
+    CounterRng(uint64_t seed = 0, uint64_t stream = 0) { reset(seed, stream); }
+
+    // Repositions the generator at the start of the given stream.
+    void reset(uint64_t seed, uint64_t stream) {
+        key[0] = static_cast<uint32_t>(seed);
+        key[1] = static_cast<uint32_t>(seed >> 32);
+        counter[0] = 0;
+        counter[1] = 0;
+        counter[2] = static_cast<uint32_t>(stream);
+        counter[3] = static_cast<uint32_t>(stream >> 32);
+        used = 4;
+    }
+
+    // Returns the next uniformly distributed 32-bit value.
+    uint32_t next() {
+        if (used == 4) refill();
+        return block[used++];
+    }
+
+    // Returns a uniformly distributed double in [0, 1).
+    double nextDouble() {
+        uint64_t hi = next() >> 5;
+        uint64_t lo = next() >> 6;
+        return static_cast<double>((hi << 26) | lo) * (1.0 / 9007199254740992.0);
+    }
+
+    // Returns true on heads for a fair coin.
+    bool coinFlip() { return (next() >> 31) != 0; }
+
+    // Returns a value in [0, n) for n > 0.
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32);
+    }
+
+private:
+    void refill() {
+        uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+            uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+            uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+            c[0] = hi1 ^ c[1] ^ k0;
+            c[1] = lo1;
+            c[2] = hi0 ^ c[3] ^ k1;
+            c[3] = lo0;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int i = 0; i < 4; ++i) block[i] = c[i];
+        if (++counter[0] == 0) ++counter[1];
+        used = 0;
+    }
+};
+
+#endif // RNG_H
@@ -0,0 +1,33 @@
+// SearchArena.cpp
+#include "SearchArena.h"
+#include <algorithm>
+
+SearchArena::SearchArena(size_t blockBytes) : blockBytes_(blockBytes) {}
+
+// Moves to the next block that fits the request, allocating one if needed.
+// Blocks start at the default new alignment, which allocate() requires.
+void *SearchArena::allocateInNextBlock(size_t bytes) {
+    size_t next = (current_ < blocks_.size()) ? current_ + 1 : 0;
+    if (next < blocks_.size() && blocks_[next].size >= bytes) {
+        current_ = next;
+    } else {
+        size_t size = std::max(blockBytes_, bytes);
+        Block block{std::make_unique<std::byte[]>(size), size};
+        if (next < blocks_.size()) {
+            // Too small for this request: replace it.
+            blocks_[next] = std::move(block);
+        } else {
+            blocks_.push_back(std::move(block));
+        }
+        current_ = next;
+    }
+    offset_ = bytes;
+    return blocks_[current_].data.get();
+}
+
+// Returns the bytes held by the arena's blocks.
+size_t SearchArena::capacity() const {
+    size_t total = 0;
+    for (const Block &block : blocks_) total += block.size;
+    return total;
+}
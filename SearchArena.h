@@ -0,0 +1,102 @@
+// SearchArena.h
+#ifndef SEARCHARENA_H
+#define SEARCHARENA_H
+
+#include "Constants.h"
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for the scratch memory of search nodes. Every thread owns
+// one (see searchArena()); memory is handed out in stack order and given back
+// by rewinding to a mark, so expanding a node never calls the global allocator
+// once the arena has grown to the depth of the search. Blocks are kept across
+// rewinds and resets.
+//
+// Tied OpenMP tasks keep this safe: a thread that runs other tasks while
+// waiting nests them on its call stack, so allocations of one thread are
+// always released in reverse order.
+class SearchArena {
+public:
+    // Position in the arena to rewind to.
+    struct Mark {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    // Creates an empty arena that grows in blocks of at least `blockBytes`.
+    explicit SearchArena(size_t blockBytes = SEARCH_ARENA_BLOCK_BYTES);
+    SearchArena(const SearchArena &) = delete;
+    SearchArena &operator=(const SearchArena &) = delete;
+
+    // Allocates uninitialized storage for `count` objects. Objects are never
+    // destroyed, so only trivially destructible types are allowed.
+    template <typename T>
+    T *allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "blocks have the default new alignment");
+        return static_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    // Returns the current position, to be passed to release().
+    Mark mark() const { return Mark{current_, offset_}; }
+
+    // Frees everything allocated since `mark` was taken.
+    void release(Mark mark) {
+        current_ = mark.block;
+        offset_ = mark.offset;
+    }
+
+    // Frees everything. Must not be called while allocations are in use.
+    void reset() { release(Mark()); }
+
+    // Returns the bytes held by the arena's blocks.
+    size_t capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void *allocateBytes(size_t bytes, size_t align) {
+        if (current_ < blocks_.size()) {
+            size_t start = (offset_ + align - 1) & ~(align - 1);
+            if (start + bytes <= blocks_[current_].size) {
+                offset_ = start + bytes;
+                return blocks_[current_].data.get() + start;
+            }
+        }
+        return allocateInNextBlock(bytes);
+    }
+    void *allocateInNextBlock(size_t bytes);
+
+    std::vector<Block> blocks_;
+    size_t blockBytes_;
+    size_t current_ = 0;    // Block allocations come from.
+    size_t offset_ = 0;     // Bytes used in the current block.
+};
+
+// Returns the arena of the calling thread.
+inline SearchArena &searchArena() {
+    thread_local SearchArena arena;
+    return arena;
+}
+
+// Releases the allocations made in the calling thread's arena during a scope.
+class ArenaScope {
+public:
+    ArenaScope() : arena_(searchArena()), mark_(arena_.mark()) {}
+    ~ArenaScope() { arena_.release(mark_); }
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    SearchArena &arena() { return arena_; }
+
+private:
+    SearchArena &arena_;
+    SearchArena::Mark mark_;
+};
+
+#endif // SEARCHARENA_H
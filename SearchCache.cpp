@@ -0,0 +1,127 @@
+// SearchCache.cpp
+#include "SearchCache.h"
+#include "TranspositionTable.h"
+#include "EngineStats.h"
+#include "Evaluation.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static const char SEARCH_CACHE_MAGIC[8] = {'T', 'C', 'G', 'P', 'S', 'R', 'C', '\0'};
+
+// Layout: this header, then `count` TTRecords.
+struct SearchCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;        // sizeof(TTRecord) of the writer.
+    uint64_t count;
+    uint64_t fingerprint;       // cardFingerprint() of the writer's card database.
+    uint64_t evaluation;        // evaluationFingerprint() of the writer.
+    uint64_t checksum;          // Of the records.
+};
+
+// Appends the bytes of a value to a fingerprint buffer.
+template <typename T>
+static void appendBytes(std::string &bytes, const T &value) {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Fingerprints every card's name and CardData record. The fields are added
+// one by one so that padding bytes do not enter the hash.
+uint64_t cardFingerprint(const CardRegistry &registry) {
+    std::string bytes;
+    const CardTable &table = registry.table();
+    for (size_t id = 0; id < registry.size(); ++id) {
+        bytes += registry.name(static_cast<CardId>(id));
+        bytes += '\0';
+        const CardData &card = table[static_cast<CardId>(id)];
+        appendBytes(bytes, card.hp);
+        appendBytes(bytes, card.cardType);
+        appendBytes(bytes, card.stage);
+        appendBytes(bytes, card.retreatCost);
+        appendBytes(bytes, card.isEx);
+        appendBytes(bytes, card.type);
+        appendBytes(bytes, card.weakness);
+        appendBytes(bytes, card.prevEvo);
+        appendBytes(bytes, card.skillCount);
+        for (int s = 0; s < card.skillCount; ++s) {
+            const SkillData &skill = card.skills[s];
+            appendBytes(bytes, skill.cost.typed.bits);
+            appendBytes(bytes, skill.cost.colorless);
+            appendBytes(bytes, skill.cost.total);
+            appendBytes(bytes, skill.opCount);
+            for (int i = 0; i < skill.opCount; ++i) {
+                appendBytes(bytes, skill.ops[i].opcode);
+                appendBytes(bytes, skill.ops[i].count);
+                appendBytes(bytes, skill.ops[i].value);
+            }
+        }
+    }
+    return imageChecksum(bytes.data(), bytes.size());
+}
+
+// Writes the transposition table to a search cache file.
+bool saveSearchCache(const std::string &filename, const CardRegistry &registry) {
+    std::vector<TTRecord> records;
+    transpositionTable.collect(records);
+
+    SearchCacheHeader header;
+    std::memcpy(header.magic, SEARCH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = SEARCH_CACHE_VERSION;
+    header.recordSize = sizeof(TTRecord);
+    header.count = records.size();
+    header.fingerprint = cardFingerprint(registry);
+    header.evaluation = evaluationFingerprint();
+    header.checksum = imageChecksum(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(TTRecord));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(&header), sizeof(header)) ||
+        !file.write(reinterpret_cast<const char *>(records.data()),
+                    static_cast<std::streamsize>(records.size() * sizeof(TTRecord)))) {
+        std::cerr << "Error: Could not write search cache " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Loads a search cache file into the transposition table.
+size_t loadSearchCache(const std::string &filename, const CardRegistry &registry) {
+    PhaseTimer timer(PHASE_LOAD);
+    size_t size = 0;
+    void *data = mapFile(filename, size);
+    if (!data) return 0;
+    const char *bytes = static_cast<const char *>(data);
+
+    SearchCacheHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        std::memcpy(&header, bytes, sizeof(header));
+        valid = std::memcmp(header.magic, SEARCH_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == SEARCH_CACHE_VERSION && header.recordSize == sizeof(TTRecord) &&
+                header.count <= size / sizeof(TTRecord) &&
+                sizeof(header) + header.count * sizeof(TTRecord) == size &&
+                imageChecksum(bytes + sizeof(header), size - sizeof(header)) == header.checksum;
+    }
+    if (!valid) {
+        std::cerr << "Warning: " << filename << " is not a valid search cache (version "
+                  << SEARCH_CACHE_VERSION << ")." << std::endl;
+        unmapFile(data, size);
+        return 0;
+    }
+    if (header.fingerprint != cardFingerprint(registry)) {
+        std::cerr << "Warning: " << filename << " was written for another card database; ignoring it." << std::endl;
+        unmapFile(data, size);
+        return 0;
+    }
+    if (header.evaluation != evaluationFingerprint()) {
+        std::cerr << "Warning: " << filename << " was written with another evaluation; ignoring it." << std::endl;
+        unmapFile(data, size);
+        return 0;
+    }
+
+    static_assert(sizeof(SearchCacheHeader) % alignof(TTRecord) == 0, "Records must be aligned in the file");
+    transpositionTable.restore(reinterpret_cast<const TTRecord *>(bytes + sizeof(header)), header.count);
+    unmapFile(data, size);
+    return header.count;
+}
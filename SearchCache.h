@@ -0,0 +1,42 @@
+// SearchCache.h
+#ifndef SEARCHCACHE_H
+#define SEARCHCACHE_H
+
+#include "CardRegistry.h"
+#include <cstdint>
+#include <string>
+
+// Version of the search cache file format. Bump when the Zobrist hash, the
+// packed transposition table entry or the search rules change, so that values
+// from older builds are not reused. Evaluation changes are caught by
+// evaluationFingerprint().
+const uint32_t SEARCH_CACHE_VERSION = 3;
+
+// Returns a fingerprint of the card data search values depend on: every
+// card's name, in ID order, and its full CardData record (stats, evolution,
+// typed costs and compiled effect programs). A cache written for one card
+// database is ignored by another.
+uint64_t cardFingerprint(const CardRegistry &registry);
+
+// Writes every position in the transposition table to a search cache file:
+// a checksummed header and the raw (key, entry) records, shallowest first.
+// Not safe to call while a search is running.
+// Parameters:
+// - filename: Path of the cache to write.
+// - registry: The card database the positions refer to.
+// Returns:
+// - true on success.
+bool saveSearchCache(const std::string &filename, const CardRegistry &registry);
+
+// Maps a search cache file and loads its positions into the transposition
+// table, so searches of positions seen in earlier sessions hit at once. A
+// missing file is not an error; a file from another format version or card
+// database is skipped with a warning.
+// Parameters:
+// - filename: Path of the cache to load.
+// - registry: The card database in use.
+// Returns:
+// - The number of positions loaded.
+size_t loadSearchCache(const std::string &filename, const CardRegistry &registry);
+
+#endif // SEARCHCACHE_H
@@ -0,0 +1,387 @@
+// SearchState.cpp
+#include "SearchState.h"
+#include "CardRegistry.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iostream>
+
+// Compiles the damage and SpecialSkill of a skill into its effect program,
+// one instruction per effect the skill has, in EffectOpcode order.
+// Returns false if the program did not fit in MAX_EFFECT_OPS instructions.
+static bool compileEffects(const Skill &skill, SkillData &out) {
+    const SpecialSkill &e = skill.specialEffect;
+    bool fits = true;
+    auto emit = [&](EffectOpcode opcode, int value, int count = 0) {
+        if (out.opCount == MAX_EFFECT_OPS) {
+            fits = false;
+            return;
+        }
+        EffectOp &op = out.ops[out.opCount++];
+        op.opcode = opcode;
+        op.value = static_cast<int16_t>(value);
+        op.count = static_cast<uint8_t>(count);
+    };
+
+    if (e.doCoinFlips) {
+        if (e.flipUntilTails) emit(OP_FLIP_UNTIL_TAILS, 0);
+        else emit(OP_FLIP_N, 0, std::min(e.numFlips, MAX_FLIP));
+    }
+    if (e.doCoinFlips && e.damagePerFlip != 0) emit(OP_DMG_PER_HEAD, e.damagePerFlip);
+    if (e.extraDmgIfPoisoned != 0) emit(OP_DMG_IF_POISONED, e.extraDmgIfPoisoned);
+    if (e.extraDmgIfParalyzed != 0) emit(OP_DMG_IF_PARALYZED, e.extraDmgIfParalyzed);
+    if (e.damagePerEnergyAttached != 0) emit(OP_DMG_PER_ENERGY, e.damagePerEnergyAttached);
+    int base = skill.dmg + e.extraDmg;
+    if (base != 0 || out.opCount > (e.doCoinFlips ? 1 : 0)) emit(OP_HIT, base);
+    if (e.randomHitCount > 0) emit(OP_RANDOM_HITS, e.randomHitDamage, std::min(e.randomHitCount, MAX_RANDOM_HITS));
+    if (e.benchedDamage > 0) emit(OP_BENCH_DMG, e.benchedDamage, e.numBenched);
+    if (e.poisonOpp) emit(OP_POISON, 0);
+    if (e.paralyzeOpp) emit(OP_PARALYZE, 0);
+    if (e.heal > 0) emit(OP_HEAL, e.heal);
+    if (e.damageReduction > 0) emit(OP_REDUCE_DMG, e.damageReduction);
+    if (e.banSupporter) emit(OP_BAN_SUPPORTER, 0);
+    if (skill.energyDrop > 0) emit(OP_DISCARD_ENERGY, skill.energyDrop);
+    if (e.shuffleOpponentBackIfHeads) emit(OP_SHUFFLE_BACK, 0);
+    if (e.switchOutOpp) emit(OP_SWITCH_OUT, 0);
+    return fits;
+}
+
+// Returns the first instruction of a skill with the given opcode, or nullptr.
+const EffectOp *findEffect(const SkillData &skill, EffectOpcode opcode) {
+    for (int i = 0; i < skill.opCount; ++i) {
+        if (skill.ops[i].opcode == opcode) return &skill.ops[i];
+    }
+    return nullptr;
+}
+
+// Appends the hot data of a card and returns its ID.
+CardId CardTable::add(const Pokemon &card) {
+    CardId id = static_cast<CardId>(storage_.size());
+    CardData d;
+    d.hp = static_cast<int16_t>(card.hp);
+    d.cardType = static_cast<uint8_t>(card.cardType);
+    d.stage = static_cast<uint8_t>(card.stage);
+    d.retreatCost = static_cast<uint8_t>(card.retreatCost);
+    d.isEx = card.isEx;
+    d.type = static_cast<int8_t>(energyIndex(card.type));
+    d.weakness = static_cast<int8_t>(energyIndex(card.weakness));
+
+    if (card.skills.size() > static_cast<size_t>(MAX_SKILLS)) {
+        std::cerr << "Warning: " << card.name << " has more than " << MAX_SKILLS
+                  << " skills; extra skills are ignored by the simulator." << std::endl;
+    }
+    for (const auto &skill : card.skills) {
+        if (d.skillCount == MAX_SKILLS) break;
+        SkillData &s = d.skills[d.skillCount++];
+        if (!compileEffects(skill, s)) {
+            std::cerr << "Warning: " << card.name << "'s " << skill.skillName << " has more than "
+                      << MAX_EFFECT_OPS << " effects; extra effects are ignored by the simulator." << std::endl;
+        }
+        for (const auto &req : skill.energyRequirements) {
+            if (req.type < 0) s.cost.colorless += static_cast<uint8_t>(req.amount);
+            else s.cost.typed.add(req.type, req.amount);
+        }
+        s.cost.total = static_cast<uint8_t>(s.cost.colorless + s.cost.typed.total());
+    }
+
+    storage_.push_back(d);
+    data_ = storage_.data();
+    size_ = storage_.size();
+    columns_.append(d);
+    return id;
+}
+
+// Uses records owned elsewhere without copying them.
+void CardTable::attach(const CardData *data, size_t count) {
+    storage_.clear();
+    data_ = data;
+    size_ = count;
+    columns_.clear();
+    for (size_t i = 0; i < count; ++i) columns_.append(data[i]);
+}
+
+// Removes all records.
+void CardTable::clear() {
+    storage_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    columns_.clear();
+}
+
+// Returns the hit damage of a skill when every coin shows tails.
+int guaranteedSkillDamage(const SkillData &skill) {
+    int damage = 0;
+    for (int i = 0; i < skill.opCount; ++i) {
+        if (skill.ops[i].opcode == OP_HIT) damage += skill.ops[i].value;
+    }
+    return damage;
+}
+
+// Appends a card's hot fields to the columns.
+void CardColumns::append(const CardData &card) {
+    hp.push_back(card.cardType == 0 ? card.hp : INT32_MAX);
+    type.push_back(card.type);
+    weakness.push_back(card.weakness);
+    for (int i = 0; i < MAX_SKILLS; ++i) {
+        int damage = 0;
+        int cost = 0;
+        if (i < card.skillCount) {
+            const SkillData &skill = card.skills[i];
+            damage = guaranteedSkillDamage(skill);
+            cost = skill.cost.total;
+        }
+        skillDamage[i].push_back(damage);
+        skillCost[i].push_back(cost);
+    }
+}
+
+// Removes all cards from the columns.
+void CardColumns::clear() {
+    hp.clear();
+    type.clear();
+    weakness.clear();
+    for (int i = 0; i < MAX_SKILLS; ++i) {
+        skillDamage[i].clear();
+        skillCost[i].clear();
+    }
+}
+
+// Creates a slot from a card on the board.
+static SlotState toSlotState(const BoardPokemon &p) {
+    SlotState slot;
+    if (p.id == NO_CARD) return slot;
+    slot.card = p.id;
+    slot.hp = static_cast<int16_t>(p.hp);
+    if (p.isPoisoned) slot.status |= STATUS_POISONED;
+    if (p.isParalyzed) slot.status |= STATUS_PARALYZED;
+    slot.energy = p.attachedEnergy;
+    return slot;
+}
+
+// Returns the energy type a list of cards generates: its most common Pokémon type.
+int deckEnergyType(const CardTable &table, const CardId *cards, size_t count) {
+    int counts[ENERGY_TYPE_COUNT] = {};
+    for (size_t i = 0; i < count; ++i) {
+        const CardData &card = table[cards[i]];
+        if (card.cardType == 0 && card.type >= 0) ++counts[card.type];
+    }
+    int *most = std::max_element(counts, counts + ENERGY_TYPE_COUNT);
+    return (*most > 0) ? static_cast<int>(most - counts) : -1;
+}
+
+// Converts the game state into a search state. The opponent's hand and deck
+// are hidden, so the opponent side holds the board only.
+SearchState toSearchState(const GameState &state) {
+    SearchState s;
+    const CardTable &table = state.cards->table();
+
+    SideState &me = s.sides[0];
+    me.active = toSlotState(state.activePokemon);
+    for (const auto &p : state.bench) {
+        if (me.benchCount < MAX_BENCH && p.id != NO_CARD) me.bench[me.benchCount++] = toSlotState(p);
+    }
+    for (CardId id : state.hand) {
+        if (me.handCount < MAX_HAND_SIZE) me.hand[me.handCount++] = id;
+    }
+    for (CardId id : state.deck) {
+        if (me.deckCount < DECK_SIZE) me.deck[me.deckCount++] = id;
+    }
+    me.points = static_cast<uint8_t>(state.yourPoints);
+    me.energyType = static_cast<int8_t>(deckEnergyType(table, state.deck.data(), state.deck.size()));
+    if (me.energyType < 0) me.energyType = static_cast<int8_t>(deckEnergyType(table, state.hand.data(), state.hand.size()));
+    if (me.active.card == NO_CARD) promoteFromBench(me);
+
+    SideState &opp = s.sides[1];
+    opp.active = toSlotState(state.opponentActivePokemon);
+    for (const auto &p : state.opponentBench) {
+        if (opp.benchCount < MAX_BENCH && p.id != NO_CARD) opp.bench[opp.benchCount++] = toSlotState(p);
+    }
+    opp.points = static_cast<uint8_t>(state.opponentPoints);
+    opp.energyType = static_cast<int8_t>(energyIndex(state.opponentEnergyType));
+    if (opp.energyType < 0 && opp.active.card != NO_CARD) opp.energyType = table[opp.active.card].type;
+    if (opp.active.card == NO_CARD) promoteFromBench(opp);
+
+    return s;
+}
+
+// Returns true if the card can be put into play as a Basic Pokémon.
+bool isBasicPokemon(const CardData &card) {
+    return card.cardType == 0 && card.stage == 0 && card.hp > 0;
+}
+
+// Returns true if the defender is weak to the attacker's type.
+bool isWeakTo(const CardTable &table, const SlotState &defender, const SlotState &attacker) {
+    if (defender.card == NO_CARD || attacker.card == NO_CARD) return false;
+    int weak = table[defender.card].weakness;
+    return weak >= 0 && weak == table[attacker.card].type;
+}
+
+// Returns the expected damage a skill deals to the defending Active Pokémon.
+double expectedSkillDamage(const CardTable &table, const SkillData &skill,
+                           const SlotState &attacker, const SlotState &defender) {
+    double heads = 0.0;
+    double damage = 0.0;
+    for (int i = 0; i < skill.opCount; ++i) {
+        const EffectOp &op = skill.ops[i];
+        switch (op.opcode) {
+        case OP_FLIP_N: heads = op.count * 0.5; break;
+        // Just under 1 expected heads when flipping until tails.
+        case OP_FLIP_UNTIL_TAILS: heads = 1.0 - std::pow(0.5, MAX_FLIP); break;
+        case OP_DMG_PER_HEAD: damage += heads * op.value; break;
+        case OP_DMG_IF_POISONED: if (defender.status & STATUS_POISONED) damage += op.value; break;
+        case OP_DMG_IF_PARALYZED: if (defender.status & STATUS_PARALYZED) damage += op.value; break;
+        case OP_DMG_PER_ENERGY: damage += op.value * totalEnergy(defender); break;
+        case OP_HIT: damage += op.value; break;
+        case OP_RANDOM_HITS: damage += static_cast<double>(op.value) * op.count; break;
+        default: break;
+        }
+    }
+    if (damage > 0 && isWeakTo(table, defender, attacker)) damage += WEAKNESS_BONUS;
+    return damage;
+}
+
+// Moves the healthiest benched Pokémon into the Active spot.
+bool promoteFromBench(SideState &side) {
+    if (side.benchCount == 0) {
+        side.active = SlotState();
+        return false;
+    }
+    int best = 0;
+    for (int i = 1; i < side.benchCount; ++i) {
+        if (side.bench[i].hp > side.bench[best].hp) best = i;
+    }
+    side.active = side.bench[best];
+    side.bench[best] = side.bench[--side.benchCount];
+    return true;
+}
+
+// Awards points for every knocked-out Pokémon on the defending side and
+// replaces a knocked-out Active Pokémon.
+void resolveKnockouts(const CardTable &table, SideState &scorer, SideState &defender) {
+    for (int i = defender.benchCount - 1; i >= 0; --i) {
+        if (defender.bench[i].hp <= 0) {
+            scorer.points += table[defender.bench[i].card].isEx ? 2 : 1;
+            defender.bench[i] = defender.bench[--defender.benchCount];
+        }
+    }
+    if (defender.active.card != NO_CARD && defender.active.hp <= 0) {
+        scorer.points += table[defender.active.card].isEx ? 2 : 1;
+        promoteFromBench(defender);
+    }
+}
+
+// Removes up to `amount` energy from a slot, most plentiful type first.
+void discardEnergy(SlotState &slot, int amount) {
+    while (amount > 0) {
+        int most = 0;
+        for (int i = 1; i < ENERGY_TYPE_COUNT; ++i) {
+            if (slot.energy[i] > slot.energy[most]) most = i;
+        }
+        if (slot.energy[most] == 0) return;
+        slot.energy.remove(most);
+        --amount;
+    }
+}
+
+// Applies a skill from the attacker's Active Pokémon to the defending side.
+void resolveAttack(const CardTable &table, SideState &atk, SideState &def,
+                   const SkillData &skill, const AttackRolls &rolls) {
+    SlotState &attacker = atk.active;
+    SlotState &target = def.active;
+
+    int heads = 0;
+    bool flipped = false;
+    bool shuffled = false;
+    int damage = 0;
+    attacker.damageReduction = 0;
+
+    for (int i = 0; i < skill.opCount; ++i) {
+        const EffectOp &op = skill.ops[i];
+        switch (op.opcode) {
+        case OP_FLIP_N:
+        case OP_FLIP_UNTIL_TAILS:
+            flipped = true;
+            heads = rolls.heads;
+            break;
+        case OP_DMG_PER_HEAD:
+            damage += heads * op.value;
+            break;
+        case OP_DMG_IF_POISONED:
+            if (target.status & STATUS_POISONED) damage += op.value;
+            break;
+        case OP_DMG_IF_PARALYZED:
+            if (target.status & STATUS_PARALYZED) damage += op.value;
+            break;
+        case OP_DMG_PER_ENERGY:
+            damage += op.value * totalEnergy(target);
+            break;
+        case OP_HIT:
+            damage += op.value;
+            if (damage > 0) {
+                if (isWeakTo(table, target, attacker)) damage += WEAKNESS_BONUS;
+                target.hp -= static_cast<int16_t>(std::max(0, damage - target.damageReduction));
+            }
+            break;
+        case OP_RANDOM_HITS:
+            // Random hits land on any of the opponent's Pokémon in play.
+            target.hp -= static_cast<int16_t>(rolls.randomHits[0] * op.value);
+            for (int b = 0; b < def.benchCount; ++b) {
+                def.bench[b].hp -= static_cast<int16_t>(rolls.randomHits[b + 1] * op.value);
+            }
+            break;
+        case OP_BENCH_DMG: {
+            int count = (op.count > 0) ? std::min<int>(op.count, def.benchCount) : def.benchCount;
+            for (int b = 0; b < count; ++b) def.bench[b].hp -= op.value;
+            break;
+        }
+        case OP_POISON:
+            if (!flipped || heads > 0) target.status |= STATUS_POISONED;
+            break;
+        case OP_PARALYZE:
+            if (!flipped || heads > 0) target.status |= STATUS_PARALYZED;
+            break;
+        case OP_HEAL:
+            attacker.hp = std::min<int16_t>(table[attacker.card].hp, static_cast<int16_t>(attacker.hp + op.value));
+            break;
+        case OP_REDUCE_DMG:
+            attacker.damageReduction = static_cast<uint8_t>(op.value);
+            break;
+        case OP_BAN_SUPPORTER:
+            def.supporterBanned = true;
+            break;
+        case OP_DISCARD_ENERGY:
+            discardEnergy(attacker, op.value);
+            break;
+        case OP_SHUFFLE_BACK:
+            if (heads > 0 && target.hp > 0) {
+                if (def.deckCount < DECK_SIZE) {
+                    int pos = (rolls.shufflePos >= 0 && rolls.shufflePos < def.deckCount) ? rolls.shufflePos : def.deckCount;
+                    def.deck[def.deckCount++] = def.deck[pos];
+                    def.deck[pos] = target.card;
+                }
+                promoteFromBench(def);
+                shuffled = true;
+            }
+            break;
+        case OP_SWITCH_OUT:
+            if (!shuffled && def.benchCount > 0 && target.hp > 0) {
+                std::swap(def.active, def.bench[std::min<int>(rolls.switchSlot, def.benchCount - 1)]);
+            }
+            break;
+        }
+    }
+
+    resolveKnockouts(table, atk, def);
+}
+
+// Returns the outcome for side 0, or -1 if the game continues.
+double gameOutcome(const SearchState &game) {
+    const SideState &me = game.sides[0];
+    const SideState &opp = game.sides[1];
+    bool won0 = me.points >= POINTS_TO_WIN || opp.active.card == NO_CARD;
+    bool won1 = opp.points >= POINTS_TO_WIN || me.active.card == NO_CARD;
+    if (won0 && won1) return 0.5;
+    if (won0) return 1.0;
+    if (won1) return 0.0;
+    return -1.0;
+}
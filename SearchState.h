@@ -0,0 +1,230 @@
+// SearchState.h
+#ifndef SEARCHSTATE_H
+#define SEARCHSTATE_H
+
+#include "PokemonCard.h"
+#include "Energy.h"
+#include "Constants.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Status condition flags stored in SlotState::status.
+const uint8_t STATUS_POISONED = 1;
+const uint8_t STATUS_PARALYZED = 2;
+
+// Flags stored in SlotState::turnFlags, cleared at the end of the owner's turn.
+const uint8_t SLOT_ENTERED_THIS_TURN = 1;     // Played or evolved this turn; cannot evolve.
+
+// Flags stored in SideState::turnFlags, cleared at the end of the side's turn.
+const uint8_t TURN_ENERGY_ATTACHED = 1;       // The Energy Zone was used.
+const uint8_t TURN_RETREATED = 2;
+const uint8_t TURN_SUPPORTER_PLAYED = 4;
+
+// --- Immutable Card Data ---
+
+// Opcodes of a compiled skill effect. A skill's program lists only the effects
+// it has, in this order, which is also the order they resolve in.
+enum EffectOpcode : uint8_t {
+    OP_FLIP_N,              // Flip `count` coins.
+    OP_FLIP_UNTIL_TAILS,    // Flip until tails, at most MAX_FLIP coins.
+    OP_DMG_PER_HEAD,        // +value damage per heads.
+    OP_DMG_IF_POISONED,     // +value damage if the defender is poisoned.
+    OP_DMG_IF_PARALYZED,    // +value damage if the defender is paralyzed.
+    OP_DMG_PER_ENERGY,      // +value damage per energy attached to the defender.
+    OP_HIT,                 // Deal value plus the damage above to the defender, with weakness.
+    OP_RANDOM_HITS,         // `count` hits of value damage on random Pokémon in play.
+    OP_BENCH_DMG,           // value damage to `count` benched Pokémon, 0 for all.
+    OP_POISON,              // Poison the defender (on heads if the skill flips).
+    OP_PARALYZE,            // Paralyze the defender (on heads if the skill flips).
+    OP_HEAL,                // Heal the attacker by value.
+    OP_REDUCE_DMG,          // Reduce damage taken during the opponent's next turn by value.
+    OP_BAN_SUPPORTER,       // The defender cannot play Supporters next turn.
+    OP_DISCARD_ENERGY,      // Discard value energy from the attacker.
+    OP_SHUFFLE_BACK,        // On heads, shuffle the defender into its deck.
+    OP_SWITCH_OUT,          // Switch the defender with a benched Pokémon.
+};
+
+// One instruction of a compiled skill effect.
+struct EffectOp {
+    uint8_t opcode = OP_HIT;                   // EffectOpcode.
+    uint8_t count = 0;                         // Coins, hits or targets.
+    int16_t value = 0;                         // Damage, heal or energy amount.
+};
+
+// Hot data of a skill: cost and the compiled effect program.
+struct SkillData {
+    EnergyCost cost;                           // Energy needed to use the skill.
+    uint8_t opCount = 0;
+    EffectOp ops[MAX_EFFECT_OPS];              // Effects, in resolution order.
+};
+
+// Returns the first instruction of a skill with the given opcode, or nullptr.
+const EffectOp *findEffect(const SkillData &skill, EffectOpcode opcode);
+
+// Hot data of a card, shared by every search state that refers to it.
+struct CardData {
+    int16_t hp = 0;                            // Printed HP.
+    uint8_t cardType = 0;                      // 0: Pokémon, 1: Supporter, 2: Item.
+    uint8_t stage = 0;                         // Evolution stage.
+    uint8_t retreatCost = 0;                   // Energy cost to retreat.
+    bool isEx = false;                         // EX Pokémon give up 2 points.
+    int8_t type = -1;                          // EnergyIndex of the Pokémon's type.
+    int8_t weakness = -1;                      // EnergyIndex of the weakness.
+    CardId prevEvo = NO_CARD;                  // Card this one evolves from.
+    uint8_t skillCount = 0;
+    SkillData skills[MAX_SKILLS];
+};
+
+// The hot card fields as parallel arrays indexed by CardId, for kernels that
+// scan the whole card pool one field at a time.
+struct CardColumns {
+    std::vector<int32_t> hp;                       // Printed HP; INT32_MAX for Trainers, so no attack knocks them out.
+    std::vector<int32_t> type;                     // EnergyIndex of the type, -1 for none.
+    std::vector<int32_t> weakness;                 // EnergyIndex of the weakness, -1 for none.
+    std::vector<int32_t> skillDamage[MAX_SKILLS];  // Guaranteed hit damage of each skill; 0 past skillCount.
+    std::vector<int32_t> skillCost[MAX_SKILLS];    // Total energy cost of each skill, typed and Colorless.
+
+    // Appends the fields of the next card.
+    void append(const CardData &card);
+    void clear();
+    size_t size() const { return hp.size(); }
+};
+
+// Returns the damage a skill's hit deals whatever the coins show: its hits
+// with every coin tails, before weakness and bonuses that depend on the
+// defender.
+int guaranteedSkillDamage(const SkillData &skill);
+
+// Immutable table of card data indexed by CardId. Built once by the card
+// registry, or attached zero-copy to the records of a mapped card image;
+// states then refer to cards by ID only.
+class CardTable {
+public:
+    // Appends the hot data of a card and returns its ID.
+    CardId add(const Pokemon &card);
+
+    // Records the card that a card evolves from.
+    void setPrevEvo(CardId id, CardId prevEvo) { storage_[id].prevEvo = prevEvo; }
+
+    // Uses records owned elsewhere, such as a mapped card image, without
+    // copying them. The records must outlive the table.
+    void attach(const CardData *data, size_t count);
+
+    const CardData &operator[](CardId id) const { return data_[id]; }
+    const CardData *data() const { return data_; }
+    const CardColumns &columns() const { return columns_; }
+    size_t size() const { return size_; }
+    void clear();
+
+private:
+    std::vector<CardData> storage_;            // Records built by add().
+    const CardData *data_ = nullptr;           // Records in use: storage_ or attached.
+    size_t size_ = 0;
+    CardColumns columns_;                      // The records' hot fields by column.
+};
+
+// --- Compact Search State ---
+
+// A board slot: a Pokémon in play and its mutable attributes.
+struct SlotState {
+    EnergyCounts energy;                       // Attached energy per type.
+    CardId card = NO_CARD;                     // NO_CARD for an empty slot.
+    int16_t hp = 0;                            // Remaining HP.
+    uint8_t status = 0;                        // STATUS_* flags.
+    uint8_t damageReduction = 0;               // Reduction during the opponent's next turn.
+    uint8_t turnFlags = 0;                     // SLOT_* flags.
+};
+
+// One player's side of the board.
+struct SideState {
+    SlotState active;
+    SlotState bench[MAX_BENCH];
+    CardId hand[MAX_HAND_SIZE] = {};
+    CardId deck[DECK_SIZE] = {};
+    uint8_t benchCount = 0;
+    uint8_t handCount = 0;
+    uint8_t deckCount = 0;
+    uint8_t points = 0;
+    int8_t energyType = -1;                    // Energy generated each turn, -1 for none.
+    bool supporterBanned = false;
+    uint8_t turnFlags = 0;                     // TURN_* flags.
+};
+
+// Complete position used by the search and the rollouts. Side 0 is the player,
+// side 1 the opponent. Copying a state is a memcpy of a few hundred bytes.
+struct SearchState {
+    SideState sides[2];
+};
+
+static_assert(std::is_trivially_copyable<SearchState>::value,
+              "SearchState must stay trivially copyable");
+
+// Converts the game state into a search state. The card IDs of both states
+// refer to the registry in `state.cards`.
+// Parameters:
+// - state: The game state to convert.
+// Returns:
+// - The equivalent search state.
+SearchState toSearchState(const GameState &state);
+
+// Returns the energy type a list of cards generates: its most common Pokémon
+// type, or -1 if it has no typed Pokémon.
+int deckEnergyType(const CardTable &table, const CardId *cards, size_t count);
+
+// --- Shared Rules on the Compact State ---
+
+// Returns the total amount of energy attached to a slot.
+inline int totalEnergy(const SlotState &slot) { return slot.energy.total(); }
+
+// Returns true if the energy attached to a slot pays for the skill, in
+// constant time; move generation asks this at every node.
+inline bool canAfford(const SlotState &slot, const SkillData &skill) { return canPay(slot.energy, skill.cost); }
+
+// Returns true if the card can be put into play as a Basic Pokémon.
+bool isBasicPokemon(const CardData &card);
+
+// Removes up to `amount` energy from a slot, most plentiful type first.
+void discardEnergy(SlotState &slot, int amount);
+
+// Returns true if the defender is weak to the attacker's type.
+bool isWeakTo(const CardTable &table, const SlotState &defender, const SlotState &attacker);
+
+// Returns the expected damage a skill deals to the defending Active Pokémon.
+double expectedSkillDamage(const CardTable &table, const SkillData &skill,
+                           const SlotState &attacker, const SlotState &defender);
+
+// Moves the healthiest benched Pokémon into the Active spot.
+// Returns false (and leaves the Active spot empty) if the bench is empty.
+bool promoteFromBench(SideState &side);
+
+// Awards points for every knocked-out Pokémon on the defending side and
+// replaces a knocked-out Active Pokémon.
+void resolveKnockouts(const CardTable &table, SideState &scorer, SideState &defender);
+
+// Random results an attack depends on. The rollouts draw them from a random
+// stream; the search enumerates them as chance outcomes.
+struct AttackRolls {
+    int heads = 0;                             // Heads flipped for the skill.
+    uint8_t randomHits[MAX_BENCH + 1] = {};    // Random hits per slot: 0 is the Active spot, i is bench i - 1.
+    int switchSlot = 0;                        // Bench slot switched in by switchOutOpp.
+    int shufflePos = -1;                       // Deck position of a shuffled-back Pokémon, -1 for the bottom.
+};
+
+// Applies a skill from the attacker's Active Pokémon to the defending side
+// with the given random results, then resolves knockouts. Runs the skill's
+// effect program one instruction at a time.
+// Parameters:
+// - table: The card table both sides refer to.
+// - atk: The attacking side.
+// - def: The defending side.
+// - skill: The skill used.
+// - rolls: The random results of the attack.
+void resolveAttack(const CardTable &table, SideState &atk, SideState &def,
+                   const SkillData &skill, const AttackRolls &rolls);
+
+// Returns the outcome for side 0 (1 win, 0.5 draw, 0 loss), or -1 if the game continues.
+double gameOutcome(const SearchState &game);
+
+#endif // SEARCHSTATE_H
@@ -0,0 +1,148 @@
+// TranspositionTable.cpp
+#include "TranspositionTable.h"
+#include "EngineStats.h"
+#include <algorithm>
+#include <cstring>
+
+// Table shared by every decision tree search in the process.
+TranspositionTable transpositionTable;
+
+// Returns the Zobrist key of a (feature, value) pair. Keys are produced by a
+// fixed 64-bit mixer instead of a stored random table, so they cover every
+// card ID without sizing a table by the registry.
+static inline uint64_t zobristKey(uint64_t feature, uint64_t value) {
+    uint64_t z = feature * 0x9E3779B97F4A7C15ULL + value + 0x632BE59BD9B4E019ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Feature numbers; each side uses its own block.
+enum ZobristFeature {
+    Z_SLOT_CARD, Z_SLOT_HP, Z_SLOT_ENERGY, Z_SLOT_FLAGS,   // Repeated per slot.
+    Z_SLOT_FEATURES,
+    Z_HAND = Z_SLOT_FEATURES * (MAX_BENCH + 1),
+    Z_DECK,
+    Z_SIDE_FLAGS,
+    Z_SIDE_FEATURES
+};
+
+// Hashes one board slot.
+static uint64_t hashSlot(const SlotState &slot, uint64_t base) {
+    if (slot.card == NO_CARD) return 0;
+    return zobristKey(base + Z_SLOT_CARD, slot.card) ^
+           zobristKey(base + Z_SLOT_HP, static_cast<uint16_t>(slot.hp)) ^
+           zobristKey(base + Z_SLOT_ENERGY, slot.energy.bits) ^
+           zobristKey(base + Z_SLOT_FLAGS, slot.status | (slot.damageReduction << 8) | (slot.turnFlags << 16));
+}
+
+// Computes the Zobrist hash of a search state.
+uint64_t zobristHash(const SearchState &state) {
+    uint64_t hash = 0;
+    for (int s = 0; s < 2; ++s) {
+        const SideState &side = state.sides[s];
+        uint64_t base = static_cast<uint64_t>(s) * Z_SIDE_FEATURES;
+
+        hash ^= hashSlot(side.active, base);
+        for (int i = 0; i < side.benchCount; ++i) {
+            hash ^= hashSlot(side.bench[i], base + (i + 1) * Z_SLOT_FEATURES);
+        }
+
+        // Multisets: summing keys keeps duplicates from cancelling out.
+        uint64_t hand = 0;
+        for (int i = 0; i < side.handCount; ++i) hand += zobristKey(base + Z_HAND, side.hand[i]);
+        uint64_t deck = 0;
+        for (int i = 0; i < side.deckCount; ++i) deck += zobristKey(base + Z_DECK, side.deck[i]);
+        hash ^= zobristKey(base + Z_HAND, hand) ^ zobristKey(base + Z_DECK, deck);
+
+        uint64_t flags = side.points | (static_cast<uint8_t>(side.energyType) << 8) |
+                         (side.supporterBanned ? 1u << 16 : 0u) | (side.benchCount << 17) |
+                         (static_cast<uint64_t>(side.turnFlags) << 24);
+        hash ^= zobristKey(base + Z_SIDE_FLAGS, flags);
+    }
+    return hash;
+}
+
+// Packs an entry into one word: value as float bits, then depth and best move.
+static uint64_t packEntry(const TTEntry &entry) {
+    float value = static_cast<float>(entry.value);
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return static_cast<uint64_t>(bits) |
+           (static_cast<uint64_t>(entry.depth & 0xFF) << 32) |
+           (static_cast<uint64_t>(entry.bestMove & 0xFF) << 40) |
+           (uint64_t(1) << 48); // Marks the slot as used.
+}
+
+static TTEntry unpackEntry(uint64_t data) {
+    TTEntry entry;
+    uint32_t bits = static_cast<uint32_t>(data);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    entry.value = value;
+    entry.depth = static_cast<int>((data >> 32) & 0xFF);
+    entry.bestMove = static_cast<int>((data >> 40) & 0xFF);
+    return entry;
+}
+
+// Creates a table with 2^sizeLog2 slots.
+TranspositionTable::TranspositionTable(int sizeLog2)
+    : slots_(new Slot[size_t(1) << sizeLog2]), mask_((size_t(1) << sizeLog2) - 1) {}
+
+// Looks up a position.
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry) const {
+    if (!enabled_) return false;
+    countStat(COUNTER_TT_PROBES);
+    const Slot &slot = slots_[key & mask_];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if (data == 0 || (check ^ data) != key) return false;
+    countStat(COUNTER_TT_HITS);
+    entry = unpackEntry(data);
+    return true;
+}
+
+// Stores a search result.
+void TranspositionTable::store(uint64_t key, const TTEntry &entry) {
+    if (!enabled_) return;
+    Slot &slot = slots_[key & mask_];
+    uint64_t old = slot.data.load(std::memory_order_relaxed);
+    if (old != 0 && (slot.check.load(std::memory_order_relaxed) ^ old) == key &&
+        unpackEntry(old).depth > entry.depth) {
+        return; // Keep the deeper result for the same position.
+    }
+    uint64_t data = packEntry(entry);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+// Appends a record of every used slot.
+void TranspositionTable::collect(std::vector<TTRecord> &records) const {
+    size_t first = records.size();
+    for (size_t i = 0; i <= mask_; ++i) {
+        uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+        if (data != 0) records.push_back(TTRecord{slots_[i].check.load(std::memory_order_relaxed) ^ data, data});
+    }
+    std::stable_sort(records.begin() + first, records.end(), [](const TTRecord &a, const TTRecord &b) {
+        return unpackEntry(a.data).depth < unpackEntry(b.data).depth;
+    });
+}
+
+// Stores records returned by collect().
+void TranspositionTable::restore(const TTRecord *records, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Slot &slot = slots_[records[i].key & mask_];
+        uint64_t old = slot.data.load(std::memory_order_relaxed);
+        if (old != 0 && unpackEntry(old).depth > unpackEntry(records[i].data).depth) continue;
+        slot.data.store(records[i].data, std::memory_order_relaxed);
+        slot.check.store(records[i].key ^ records[i].data, std::memory_order_relaxed);
+    }
+}
+
+// Removes all entries.
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].data.store(0, std::memory_order_relaxed);
+        slots_[i].check.store(0, std::memory_order_relaxed);
+    }
+}
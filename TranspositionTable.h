@@ -0,0 +1,86 @@
+// TranspositionTable.h
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "SearchState.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Marks an entry that has no best move (leaf or terminal position).
+const int NO_MOVE = 0xFF;
+
+// Result of a search stored for a position.
+struct TTEntry {
+    double value = 0.0;     // Backed-up value of the position.
+    int depth = 0;          // Remaining depth the value was searched to.
+    int bestMove = NO_MOVE; // Index of the best child, or NO_MOVE.
+};
+
+// A used slot as raw words: the position's key and its packed entry. Records
+// are what search cache files store.
+struct TTRecord {
+    uint64_t key;
+    uint64_t data;
+};
+
+// Computes the Zobrist hash of a search state: the XOR of one 64-bit key per
+// (feature, value) pair. Hands and decks are hashed as multisets, so the order
+// of hidden cards does not split positions.
+// Parameters:
+// - state: The state to hash.
+// Returns:
+// - The 64-bit hash.
+uint64_t zobristHash(const SearchState &state);
+
+// Fixed-size, lock-free transposition table shared by all search threads.
+// Each slot holds two 64-bit words written with relaxed atomics: the packed
+// entry and the key XOR the packed entry. A torn write from a concurrent store
+// fails the key check on probe and reads as a miss.
+class TranspositionTable {
+public:
+    // Creates a table with 2^sizeLog2 slots.
+    explicit TranspositionTable(int sizeLog2 = TT_SIZE_LOG2);
+
+    // Looks up a position. Returns true and fills `entry` on a hit.
+    bool probe(uint64_t key, TTEntry &entry) const;
+
+    // Stores a search result. An entry for the same position is only replaced
+    // by a search of at least the same depth.
+    void store(uint64_t key, const TTEntry &entry);
+
+    // Removes all entries. Not safe to call while a search is running.
+    void clear();
+
+    // Appends a record of every used slot, shallowest search first, so that
+    // restoring them into a smaller table lets deeper results win shared
+    // slots. Not safe to call while a search is running.
+    void collect(std::vector<TTRecord> &records) const;
+
+    // Stores records returned by collect(), keeping the deeper result where
+    // two records share a slot.
+    void restore(const TTRecord *records, size_t count);
+
+    // Turns the table on or off. A disabled table misses every probe and
+    // ignores stores; used to measure the raw search.
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+
+    size_t size() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};   // key ^ data
+        std::atomic<uint64_t> data{0};    // Packed TTEntry; 0 means empty.
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    bool enabled_ = true;
+};
+
+// Table shared by every decision tree search in the process.
+extern TranspositionTable transpositionTable;
+
+#endif // TRANSPOSITIONTABLE_H
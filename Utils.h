@@ -3,6 +3,7 @@
 #define UTILS_H
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <algorithm>
@@ -40,4 +41,45 @@ inline std::string normalize(const std::string &s) {
     return normalized;
 }
 
+// --- Non-Allocating Helpers ---
+// These work on views into a buffer that outlives them, such as a whole file
+// read at once.
+
+// Removes leading and trailing whitespace from a view without copying.
+inline std::string_view trimView(std::string_view s) {
+    size_t start = s.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) return std::string_view();
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+// Returns the next line of `text` without its line ending and advances `text`
+// past it. Returns false when `text` is exhausted.
+inline bool nextLine(std::string_view &text, std::string_view &line) {
+    if (text.empty()) return false;
+    size_t end = text.find('\n');
+    line = text.substr(0, end);
+    text = (end == std::string_view::npos) ? std::string_view() : text.substr(end + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return true;
+}
+
+// Returns the trimmed token before the next `delimiter` and advances `rest`
+// past it. The last token is the trimmed remainder.
+inline std::string_view nextToken(std::string_view &rest, char delimiter) {
+    size_t end = rest.find(delimiter);
+    std::string_view token = rest.substr(0, end);
+    rest = (end == std::string_view::npos) ? std::string_view() : rest.substr(end + 1);
+    return trimView(token);
+}
+
+// Compares two views ignoring ASCII case.
+inline bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
 #endif // UTILS_H
@@ -1,21 +1,190 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <unordered_map>
 #include "PokemonCard.h"
+#include "BatchAnalysis.h"
+#include "CardRegistry.h"
+#include "DeckBuilder.h"
 #include "FileParser.h"
 #include "GameSimulation.h"
+#include "Knockouts.h"
+#include "Mcts.h"
+#include "MetaDecks.h"
+#include "MoveGen.h"
+#include "SearchCache.h"
 #include "Utils.h"
 
-int main() {
-    // Load the card map from the card file.
-    std::unordered_map<std::string, Pokemon> cardMap;
+// Non-interactive mode: analyzes every position in a file and writes one
+// result per position.
+// Usage: project --batch <positions> [--out <file>] [--format csv|jsonl]
+//                [--budget <ms>] [--depth <plies>] [--rollouts <n>]
+//                [--mcts root|tree] [--stats-interval <ms>] [--cache <file>]
+// The format defaults to JSON Lines for a .jsonl output file, CSV otherwise.
+// Returns:
+// - The process exit code.
+static int runBatch(int argc, char **argv, const CardRegistry &registry) {
+    std::string inputFile;
+    std::string outputFile;
+    std::string format;
+    BatchOptions options;
+    int statsIntervalMs = 0;
+    std::string cacheFile;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--batch") == 0 && hasValue) inputFile = argv[++i];
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue) outputFile = argv[++i];
+        else if (std::strcmp(argv[i], "--format") == 0 && hasValue) format = argv[++i];
+        else if (std::strcmp(argv[i], "--budget") == 0 && hasValue) options.searchBudgetMs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--depth") == 0 && hasValue) options.maxDepth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rollouts") == 0 && hasValue) options.rollouts = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--mcts") == 0 && hasValue) {
+            std::string mode = argv[++i];
+            if (mode != "root" && mode != "tree") {
+                std::cerr << "Error: Unknown tree search mode: " << mode << std::endl;
+                return 1;
+            }
+            options.mcts = true;
+            options.mctsMode = (mode == "root") ? MCTS_ROOT_PARALLEL : MCTS_TREE_PARALLEL;
+        }
+        else if (std::strcmp(argv[i], "--stats-interval") == 0 && hasValue) statsIntervalMs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--cache") == 0 && hasValue) cacheFile = argv[++i];
+        else {
+            std::cerr << "Error: Unrecognized argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (inputFile.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --batch <positions> [--out <file>] [--format csv|jsonl]"
+                  << " [--budget <ms>] [--depth <plies>] [--rollouts <n>]"
+                  << " [--mcts root|tree] [--stats-interval <ms>] [--cache <file>]" << std::endl;
+        return 1;
+    }
+    if (format.empty()) {
+        bool jsonl = outputFile.size() >= 6 && outputFile.compare(outputFile.size() - 6, 6, ".jsonl") == 0;
+        format = jsonl ? "jsonl" : "csv";
+    }
+    if (format != "csv" && format != "jsonl") {
+        std::cerr << "Error: Unknown output format: " << format << std::endl;
+        return 1;
+    }
+
+    std::vector<BatchPosition> positions;
+    if (!loadBatchPositions(inputFile, registry, positions)) return 1;
+    if (!cacheFile.empty()) {
+        size_t cachedPositions = loadSearchCache(cacheFile, registry);
+        std::cerr << "Positions loaded from the search cache: " << cachedPositions << std::endl;
+    }
+    std::cerr << "Analyzing " << positions.size() << " positions..." << std::endl;
+    SearchStats before = statsSnapshot();
+    if (statsIntervalMs > 0) startStatsDump(std::cerr, statsIntervalMs);
+    std::vector<BatchResult> results = analyzePositions(positions, options);
+    stopStatsDump();
+    printStats(std::cerr, statsDifference(statsSnapshot(), before));
+    if (!cacheFile.empty()) saveSearchCache(cacheFile, registry);
+
+    BatchFormat batchFormat = (format == "jsonl") ? BATCH_JSONL : BATCH_CSV;
+    if (outputFile.empty()) {
+        writeBatchResults(std::cout, results, registry, batchFormat, options.mcts);
+        return 0;
+    }
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open output file: " << outputFile << std::endl;
+        return 1;
+    }
+    writeBatchResults(out, results, registry, batchFormat, options.mcts);
+    return 0;
+}
+
+// Deck-building mode: improves deck.txt against the meta-decks and writes the
+// best deck found in the format of deck.txt.
+// Usage: project --build-deck [--games <n>] [--steps <n>] [--candidates <n>]
+//                [--out <file>]
+// Returns:
+// - The process exit code.
+static int runDeckBuilder(int argc, char **argv, const CardRegistry &registry) {
+    std::string outputFile;
+    DeckBuilderOptions options;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--build-deck") == 0) continue;
+        else if (std::strcmp(argv[i], "--games") == 0 && hasValue) options.gamesPerDeck = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--steps") == 0 && hasValue) options.steps = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--candidates") == 0 && hasValue) options.candidatesPerStep = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--out") == 0 && hasValue) outputFile = argv[++i];
+        else {
+            std::cerr << "Error: Unrecognized argument: " << argv[i] << std::endl;
+            std::cerr << "Usage: " << argv[0] << " --build-deck [--games <n>] [--steps <n>] [--candidates <n>]"
+                      << " [--out <file>]" << std::endl;
+            return 1;
+        }
+    }
+    if (options.gamesPerDeck <= 0) {
+        std::cerr << "Error: --games must be positive." << std::endl;
+        return 1;
+    }
+
+    std::vector<CardId> start;
+    loadPresetDeck("deck.txt", registry, start);
+    std::cerr << "Building a deck from " << options.gamesPerDeck << " games per deck..." << std::endl;
+    SearchStats before = statsSnapshot();
+    DeckBuilderResult result = optimizeDeck(registry, start, options);
+    printStats(std::cerr, statsDifference(statsSnapshot(), before));
+    if (result.deck.empty()) return 1;
+    std::cerr << "Win rate: " << result.winRate * 100.0 << "% after " << result.decksEvaluated << " decks ("
+              << result.gamesPlayed << " games played, " << result.gamesReused << " reused)" << std::endl;
+
+    if (outputFile.empty()) {
+        writeDeckFile(std::cout, registry, result.deck);
+        return 0;
+    }
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open output file: " << outputFile << std::endl;
+        return 1;
+    }
+    writeDeckFile(out, registry, result.deck);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // Batch and deck-building modes keep stdout for the results.
+    bool batch = argc > 1;
+    std::ostream &log = batch ? std::cerr : std::cout;
+
+    // Load the card registry from the compiled card image, or the card file.
+    CardRegistry registry;
     const std::string cardFile = "Cards.txt";
-    loadCardMapFromFile(cardFile, cardMap);
-    std::cout << "Total cards loaded from file: " << cardMap.size() << std::endl;
+    const std::string cardImage = "Cards.bin";  // Written by compile_cards.
+    loadCardRegistry(cardFile, cardImage, registry);
+    log << "Total cards loaded from file: " << registry.size() << std::endl;
+
+    // Compile the meta-deck lists used to guess the opponent's deck.
+    const std::string metaDeckFile = "metaDecks.txt";
+    loadAllMetaDecks(metaDeckFile, registry);
+    log << "Total meta-decks loaded from file: " << allMetaDecks.size() << std::endl;
+
+    if (batch) {
+        bool buildDeck = false;
+        for (int i = 1; i < argc; ++i) buildDeck = buildDeck || std::strcmp(argv[i], "--build-deck") == 0;
+        return buildDeck ? runDeckBuilder(argc, argv, registry) : runBatch(argc, argv, registry);
+    }
+
+    // Positions searched in earlier sessions are answered from the table at
+    // once. The table is never cleared, so each round's searches also carry
+    // over to the next round.
+    const std::string searchCacheFile = "SearchCache.bin";  // Rewritten after every round.
+    size_t cachedPositions = loadSearchCache(searchCacheFile, registry);
+    if (cachedPositions > 0) {
+        std::cout << "Positions loaded from the search cache: " << cachedPositions << std::endl;
+    }
 
     // Initialize game state and load the preset deck.
     GameState state;
+    state.cards = &registry;
     const std::string deckFile = "deck.txt";  // Path to the player's deck file.
-    loadPresetDeck(deckFile, cardMap, state.deck);
+    loadPresetDeck(deckFile, registry, state.deck);
     preStartConfiguration(state);
 
     // Pre-1st Round: Initial configuration.
@@ -23,7 +192,7 @@ int main() {
     drawInitialHand(state);
 
     // Post-1st Round: Update board state after round one.
-    postFirstRoundUpdate(state, cardMap);
+    postFirstRoundUpdate(state, registry);
 
     // Simulate multiple rounds.
     const int maxRounds = 5; // Number of rounds to simulate.
@@ -39,10 +208,44 @@ int main() {
         // Post-round update: Update the game state after the round.
         postEveryRoundUpdate(state);
 
-        // Simulate decision tree to evaluate the best move.
-        int simulationDepth = 3; // Depth of the decision tree simulation.
-        double winProbability = simulateDecisionTree(state, simulationDepth) * 100; // Convert to percentage.
-        std::cout << "Winning probability for this round: " << winProbability << "%" << std::endl;
+        SearchStats roundStart = statsSnapshot();
+
+        // Estimate the opponent's deck from their visible board.
+        updateMetaDeckGuesses(state);
+        std::cout << "Possible opponent meta-decks: " << state.oppMetaDeckGuesses.size() << std::endl;
+        if (!state.oppMetaDeckGuesses.empty()) {
+            const MetaDeckGuess &top = state.oppMetaDeckGuesses.front();
+            std::cout << "Most likely meta-deck: #" << top.deck + 1 << " ("
+                      << top.probability * 100 << "%)" << std::endl;
+        }
+
+        // Search the decision tree for the best move within the time budget.
+        const int searchBudgetMs = 1000; // Time budget of the decision tree search.
+        SearchResult search = simulateDecisionTreeWithBudget(state, searchBudgetMs);
+        if (search.bestMove != NO_MOVE) {
+            std::cout << "Best move: " << registry.name(search.attacker) << " uses "
+                      << registry.skillName(search.attacker, search.bestMove)
+                      << " (searched " << search.depth << " plies deep)" << std::endl;
+        }
+        std::cout << "Winning probability for this round: " << search.value * 100 << "%" << std::endl;
+        SearchState board = toSearchState(state);
+        printKnockouts(std::cout, registry, board.sides[0], board.sides[1]);
+
+        // Plan the whole turn with the tree search, which also weighs energy,
+        // evolution, retreat and Trainer moves.
+        MctsOptions mctsOptions;
+        mctsOptions.budgetMs = searchBudgetMs;
+        MctsResult plan = mctsSearch(state, mctsOptions);
+        std::cout << "Tree search suggests: " << describeMove(registry, board.sides[0], plan.bestMove)
+                  << " (" << plan.value * 100 << "% over " << plan.iterations << " games)" << std::endl;
+
+        // Play out the rest of the game to estimate the win rate.
+        const int monteCarloRollouts = 10000; // Number of Monte Carlo rollouts.
+        MonteCarloResult mc = monteCarloSimulation(state, monteCarloRollouts);
+        std::cout << "Monte Carlo win rate: " << mc.winRate * 100 << "% (95% CI "
+                  << mc.ciLow * 100 << "% - " << mc.ciHigh * 100 << "%)" << std::endl;
+        printStats(std::cout, statsDifference(statsSnapshot(), roundStart));
+        saveSearchCache(searchCacheFile, registry);
 
         // Increment the turn counter.
         state.turn++;